@@ -0,0 +1,46 @@
+/**
+ * @file   bench.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 14:30:12 2026
+ *
+ * @brief  Header file for RiNOO microbenchmarks
+ *
+ *
+ */
+
+#ifndef RINOO_BENCH_H_
+#define RINOO_BENCH_H_
+
+#include "rinoo/rinoo.h"
+
+typedef struct s_bench {
+	const char *name;
+	uint64_t iterations;
+	void (*run)(struct s_bench *bench);
+	bool failed;
+	uint64_t start;
+	uint64_t elapsed;
+} t_bench;
+
+uint64_t bench_clock(void);
+void bench_start(t_bench *bench);
+void bench_stop(t_bench *bench);
+void bench_fail(t_bench *bench, const char *reason);
+
+/* Scheduler benchmarks */
+void bench_fcontext_swap(t_bench *bench);
+void bench_task_start(t_bench *bench);
+void bench_task_yield(t_bench *bench);
+void bench_timer_arm_cancel(t_bench *bench);
+void bench_channel_pingpong(t_bench *bench);
+void bench_sched_waitfor(t_bench *bench);
+
+/* Network benchmarks */
+void bench_udp_single(t_bench *bench);
+void bench_udp_batch(t_bench *bench);
+void bench_tcp_pingpong(t_bench *bench);
+void bench_unix_pingpong(t_bench *bench);
+void bench_ssl_handshake_rsa(t_bench *bench);
+void bench_ssl_handshake_ecdsa(t_bench *bench);
+
+#endif /* !RINOO_BENCH_H_ */
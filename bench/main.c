@@ -0,0 +1,131 @@
+/**
+ * @file   main.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 14:30:12 2026
+ *
+ * @brief  RiNOO microbenchmarks entry point
+ *
+ * Usage: rinoo_bench [name...]
+ * Runs every benchmark (or only the ones named) with fixed iteration
+ * counts and prints the results as JSON on stdout.
+ *
+ */
+
+#include "bench.h"
+
+static t_bench benches[] = {
+	{ "fcontext_swap", 10000000, bench_fcontext_swap, false, 0, 0 },
+	{ "task_start_destroy", 1000000, bench_task_start, false, 0, 0 },
+	{ "task_yield", 5000000, bench_task_yield, false, 0, 0 },
+	{ "timer_arm_cancel_1M_pending", 1000000, bench_timer_arm_cancel, false, 0, 0 },
+	{ "channel_pingpong", 1000000, bench_channel_pingpong, false, 0, 0 },
+	{ "sched_waitfor_socketpair", 200000, bench_sched_waitfor, false, 0, 0 },
+	{ "udp_write_recvfrom", 1000000, bench_udp_single, false, 0, 0 },
+	{ "udp_sendmmsg_recvmmsg", 1000000, bench_udp_batch, false, 0, 0 },
+	{ "tcp_loopback_pingpong", 200000, bench_tcp_pingpong, false, 0, 0 },
+	{ "unix_stream_pingpong", 200000, bench_unix_pingpong, false, 0, 0 },
+	{ "ssl_handshake_rsa2048", 2000, bench_ssl_handshake_rsa, false, 0, 0 },
+	{ "ssl_handshake_ecdsa_p256", 2000, bench_ssl_handshake_ecdsa, false, 0, 0 },
+};
+
+/**
+ * Gets a monotonic time in nanoseconds.
+ *
+ *
+ * @return Current time in ns
+ */
+uint64_t bench_clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * RINOO_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/**
+ * Starts measuring a benchmark.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_start(t_bench *bench)
+{
+	bench->start = bench_clock();
+}
+
+/**
+ * Stops measuring a benchmark.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_stop(t_bench *bench)
+{
+	bench->elapsed = bench_clock() - bench->start;
+}
+
+/**
+ * Marks a benchmark as failed.
+ *
+ * @param bench Pointer to the benchmark
+ * @param reason Failure description
+ */
+void bench_fail(t_bench *bench, const char *reason)
+{
+	bench->failed = true;
+	fprintf(stderr, "%s: %s\n", bench->name, reason);
+}
+
+static bool bench_selected(const char *name, int argc, char **argv)
+{
+	int i;
+
+	if (argc < 2) {
+		return true;
+	}
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Main function for benchmarks.
+ *
+ * @param argc Number of arguments
+ * @param argv Benchmark names to run, all if none
+ *
+ * @return 0 if all benchmarks succeeded, otherwise 1
+ */
+int main(int argc, char **argv)
+{
+	size_t i;
+	int ret;
+	bool first;
+	t_bench *bench;
+
+	ret = 0;
+	first = true;
+	printf("{\n  \"version\": \"%s\",\n  \"benchmarks\": [", VERSION);
+	for (i = 0; i < ARRAY_SIZE(benches); i++) {
+		bench = &benches[i];
+		if (!bench_selected(bench->name, argc, argv)) {
+			continue;
+		}
+		bench->run(bench);
+		printf("%s\n    { \"name\": \"%s\", \"iterations\": %llu", (first ? "" : ","), bench->name, (unsigned long long) bench->iterations);
+		if (bench->failed || bench->elapsed == 0) {
+			printf(", \"error\": true }");
+			ret = 1;
+		} else {
+			printf(", \"ns_total\": %llu, \"ns_per_op\": %.2f, \"ops_per_sec\": %.0f }",
+			       (unsigned long long) bench->elapsed,
+			       (double) bench->elapsed / bench->iterations,
+			       (double) bench->iterations * RINOO_NSEC_PER_SEC / bench->elapsed);
+		}
+		fflush(stdout);
+		first = false;
+	}
+	printf("\n  ]\n}\n");
+	return ret;
+}
@@ -0,0 +1,387 @@
+/**
+ * @file   net.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 15:58:21 2026
+ *
+ * @brief  Network microbenchmarks
+ *
+ *
+ */
+
+#include "bench.h"
+
+#define BENCH_UDP_PORT		4343
+#define BENCH_UDP_SIZE		64
+#define BENCH_UDP_WINDOW	RINOO_SOCKET_MMSG_MAX
+#define BENCH_STREAM_PORT	4344
+#define BENCH_STREAM_PATH	"@rinoo_bench"
+#define BENCH_STREAM_SIZE	64
+#define BENCH_SSL_PORT		4345
+
+extern const t_socket_class socket_class_udp;
+
+typedef struct s_bench_udp {
+	t_bench *bench;
+	t_sched *sched;
+	t_socket *server;
+	t_socket *client;
+	bool failed;
+	char data[BENCH_UDP_WINDOW][BENCH_UDP_SIZE];
+	t_buffer buffers[BENCH_UDP_WINDOW];
+	t_socket_msg msgs[BENCH_UDP_WINDOW];
+} t_bench_udp;
+
+typedef struct s_bench_stream {
+	t_bench *bench;
+	t_sched *sched;
+	t_socket *server;
+	bool local;
+	bool failed;
+} t_bench_stream;
+
+typedef struct s_bench_ssl {
+	t_bench *bench;
+	t_sched *sched;
+	t_ssl_ctx *ctx;
+	t_socket *server;
+	bool failed;
+} t_bench_ssl;
+
+/**
+ * Creates a bound UDP server and a client connected to it on loopback.
+ *
+ * @param udp Pointer to the benchmark context to fill
+ *
+ * @return 0 on success, otherwise -1
+ */
+static int bench_udp_init(t_bench_udp *udp)
+{
+	int i;
+	struct sockaddr_in addr;
+
+	udp->sched = rinoo_sched();
+	if (udp->sched == NULL) {
+		return -1;
+	}
+	udp->server = rinoo_socket(udp->sched, &socket_class_udp);
+	if (udp->server == NULL) {
+		return -1;
+	}
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(BENCH_UDP_PORT);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (rinoo_socket_bind(udp->server, (struct sockaddr *) &addr, sizeof(addr), 0) != 0) {
+		return -1;
+	}
+	udp->client = rinoo_udp_client(udp->sched, IP_LOOPBACK, BENCH_UDP_PORT);
+	if (udp->client == NULL) {
+		return -1;
+	}
+	for (i = 0; i < BENCH_UDP_WINDOW; i++) {
+		buffer_set(&udp->buffers[i], udp->data[i], BENCH_UDP_SIZE);
+		udp->msgs[i].buffer = &udp->buffers[i];
+	}
+	return 0;
+}
+
+static void bench_udp_destroy(t_bench_udp *udp)
+{
+	if (udp->client != NULL) {
+		rinoo_socket_destroy(udp->client);
+	}
+	if (udp->server != NULL) {
+		rinoo_socket_destroy(udp->server);
+	}
+	if (udp->sched != NULL) {
+		rinoo_sched_destroy(udp->sched);
+	}
+}
+
+static void bench_udp_single_func(void *arg)
+{
+	int i;
+	uint64_t done;
+	t_bench_udp *udp = arg;
+	char buf[BENCH_UDP_SIZE];
+
+	memset(buf, 'x', sizeof(buf));
+	/* Windows keep loopback receive queue from dropping datagrams */
+	for (done = 0; done < udp->bench->iterations; done += BENCH_UDP_WINDOW) {
+		for (i = 0; i < BENCH_UDP_WINDOW; i++) {
+			if (rinoo_socket_write(udp->client, buf, sizeof(buf)) != sizeof(buf)) {
+				udp->failed = true;
+				return;
+			}
+		}
+		for (i = 0; i < BENCH_UDP_WINDOW; i++) {
+			if (rinoo_socket_recvfrom(udp->server, buf, sizeof(buf), NULL, NULL) != sizeof(buf)) {
+				udp->failed = true;
+				return;
+			}
+		}
+	}
+}
+
+static void bench_udp_batch_func(void *arg)
+{
+	int i;
+	int ret;
+	int received;
+	uint64_t done;
+	t_bench_udp *udp = arg;
+
+	for (done = 0; done < udp->bench->iterations; done += BENCH_UDP_WINDOW) {
+		for (i = 0; i < BENCH_UDP_WINDOW; i++) {
+			buffer_setsize(&udp->buffers[i], BENCH_UDP_SIZE);
+			udp->msgs[i].addrlen = 0;
+		}
+		if (rinoo_socket_sendmmsg(udp->client, udp->msgs, BENCH_UDP_WINDOW) != BENCH_UDP_WINDOW) {
+			udp->failed = true;
+			return;
+		}
+		for (received = 0; received < BENCH_UDP_WINDOW; received += ret) {
+			ret = rinoo_socket_recvmmsg(udp->server, &udp->msgs[received], BENCH_UDP_WINDOW - received);
+			if (ret <= 0) {
+				udp->failed = true;
+				return;
+			}
+		}
+	}
+}
+
+static void bench_udp_run(t_bench *bench, void (*func)(void *arg))
+{
+	t_bench_udp *udp;
+
+	udp = calloc(1, sizeof(*udp));
+	if (udp == NULL) {
+		bench_fail(bench, "calloc failed");
+		return;
+	}
+	udp->bench = bench;
+	if (bench_udp_init(udp) != 0) {
+		bench_fail(bench, "UDP socket setup failed");
+		bench_udp_destroy(udp);
+		free(udp);
+		return;
+	}
+	rinoo_task_start(udp->sched, func, udp);
+	bench_start(bench);
+	rinoo_sched_loop(udp->sched);
+	bench_stop(bench);
+	if (udp->failed) {
+		bench_fail(bench, "UDP I/O failed");
+	}
+	bench_udp_destroy(udp);
+	free(udp);
+}
+
+/**
+ * Measures loopback UDP datagrams moved one per syscall (write/recvfrom).
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_udp_single(t_bench *bench)
+{
+	bench_udp_run(bench, bench_udp_single_func);
+}
+
+/**
+ * Measures loopback UDP datagrams moved in batches (sendmmsg/recvmmsg).
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_udp_batch(t_bench *bench)
+{
+	bench_udp_run(bench, bench_udp_batch_func);
+}
+
+static void bench_stream_echo_func(void *arg)
+{
+	t_socket *client;
+	t_bench_stream *stream = arg;
+	char buf[BENCH_STREAM_SIZE];
+
+	client = rinoo_socket_accept(stream->server, NULL, NULL);
+	if (client == NULL) {
+		stream->failed = true;
+		return;
+	}
+	while (rinoo_socket_read_exact(client, buf, sizeof(buf)) == sizeof(buf)) {
+		if (rinoo_socket_write(client, buf, sizeof(buf)) != sizeof(buf)) {
+			stream->failed = true;
+			break;
+		}
+	}
+	rinoo_socket_destroy(client);
+}
+
+static void bench_stream_client_func(void *arg)
+{
+	uint64_t i;
+	t_socket *client;
+	t_bench_stream *stream = arg;
+	char buf[BENCH_STREAM_SIZE];
+
+	if (stream->local) {
+		client = rinoo_unix_client(stream->sched, BENCH_STREAM_PATH, 0);
+	} else {
+		client = rinoo_tcp_client(stream->sched, IP_LOOPBACK, BENCH_STREAM_PORT, 0);
+	}
+	if (client == NULL) {
+		stream->failed = true;
+		return;
+	}
+	memset(buf, 'x', sizeof(buf));
+	bench_start(stream->bench);
+	for (i = 0; i < stream->bench->iterations; i++) {
+		if (rinoo_socket_write(client, buf, sizeof(buf)) != sizeof(buf) ||
+		    rinoo_socket_read_exact(client, buf, sizeof(buf)) != sizeof(buf)) {
+			stream->failed = true;
+			break;
+		}
+	}
+	bench_stop(stream->bench);
+	rinoo_socket_destroy(client);
+}
+
+static void bench_stream_run(t_bench *bench, bool local)
+{
+	t_bench_stream stream;
+
+	memset(&stream, 0, sizeof(stream));
+	stream.bench = bench;
+	stream.local = local;
+	stream.sched = rinoo_sched();
+	if (stream.sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		return;
+	}
+	if (local) {
+		stream.server = rinoo_unix_server(stream.sched, BENCH_STREAM_PATH);
+	} else {
+		stream.server = rinoo_tcp_server(stream.sched, IP_ANY, BENCH_STREAM_PORT);
+	}
+	if (stream.server == NULL) {
+		bench_fail(bench, "stream server setup failed");
+		rinoo_sched_destroy(stream.sched);
+		return;
+	}
+	rinoo_task_start(stream.sched, bench_stream_echo_func, &stream);
+	rinoo_task_start(stream.sched, bench_stream_client_func, &stream);
+	rinoo_sched_loop(stream.sched);
+	if (stream.failed) {
+		bench_fail(bench, "stream I/O failed");
+	}
+	rinoo_socket_destroy(stream.server);
+	rinoo_sched_destroy(stream.sched);
+}
+
+/**
+ * Measures 64 bytes round-trips on a loopback TCP connection.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_tcp_pingpong(t_bench *bench)
+{
+	bench_stream_run(bench, false);
+}
+
+/**
+ * Measures 64 bytes round-trips on an abstract unix stream socket.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_unix_pingpong(t_bench *bench)
+{
+	bench_stream_run(bench, true);
+}
+
+static void bench_ssl_server_func(void *arg)
+{
+	uint64_t i;
+	t_socket *client;
+	t_bench_ssl *ssl = arg;
+
+	for (i = 0; i < ssl->bench->iterations; i++) {
+		client = rinoo_ssl_accept(ssl->server, NULL, NULL);
+		if (client == NULL) {
+			ssl->failed = true;
+			return;
+		}
+		rinoo_socket_destroy(client);
+	}
+}
+
+static void bench_ssl_client_func(void *arg)
+{
+	uint64_t i;
+	t_socket *client;
+	t_bench_ssl *ssl = arg;
+
+	bench_start(ssl->bench);
+	for (i = 0; i < ssl->bench->iterations; i++) {
+		client = rinoo_ssl_client(ssl->sched, ssl->ctx, IP_LOOPBACK, BENCH_SSL_PORT, 0);
+		if (client == NULL) {
+			ssl->failed = true;
+			break;
+		}
+		rinoo_socket_destroy(client);
+	}
+	bench_stop(ssl->bench);
+}
+
+static void bench_ssl_run(t_bench *bench, t_ssl_ctx *(*context)(void))
+{
+	t_bench_ssl ssl;
+
+	memset(&ssl, 0, sizeof(ssl));
+	ssl.bench = bench;
+	ssl.ctx = context();
+	if (ssl.ctx == NULL) {
+		bench_fail(bench, "SSL context creation failed");
+		return;
+	}
+	ssl.sched = rinoo_sched();
+	if (ssl.sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		rinoo_ssl_context_destroy(ssl.ctx);
+		return;
+	}
+	ssl.server = rinoo_ssl_server(ssl.sched, ssl.ctx, IP_ANY, BENCH_SSL_PORT);
+	if (ssl.server == NULL) {
+		bench_fail(bench, "SSL server setup failed");
+		rinoo_sched_destroy(ssl.sched);
+		rinoo_ssl_context_destroy(ssl.ctx);
+		return;
+	}
+	rinoo_task_start(ssl.sched, bench_ssl_server_func, &ssl);
+	rinoo_task_start(ssl.sched, bench_ssl_client_func, &ssl);
+	rinoo_sched_loop(ssl.sched);
+	if (ssl.failed) {
+		bench_fail(bench, "SSL handshake failed");
+	}
+	rinoo_socket_destroy(ssl.server);
+	rinoo_sched_destroy(ssl.sched);
+	rinoo_ssl_context_destroy(ssl.ctx);
+}
+
+/**
+ * Measures full TLS handshakes on loopback with a RSA 2048 certificate.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_ssl_handshake_rsa(t_bench *bench)
+{
+	bench_ssl_run(bench, rinoo_ssl_context);
+}
+
+/**
+ * Measures full TLS handshakes on loopback with an ECDSA P-256 certificate.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_ssl_handshake_ecdsa(t_bench *bench)
+{
+	bench_ssl_run(bench, rinoo_ssl_context_ecdsa);
+}
@@ -0,0 +1,333 @@
+/**
+ * @file   scheduler.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 14:30:12 2026
+ *
+ * @brief  Scheduler and context switch microbenchmarks
+ *
+ *
+ */
+
+#include "bench.h"
+
+#define BENCH_TASK_BATCH	1000
+#define BENCH_PENDING_TIMERS	1000000
+
+static t_fcontext fcontext_main;
+static t_fcontext fcontext_task;
+static char fcontext_stack[RINOO_TASK_STACK_SIZE];
+
+static void bench_fcontext_func(void *unused(arg))
+{
+	for (;;) {
+		fcontext_swap(&fcontext_task, &fcontext_main);
+	}
+}
+
+/**
+ * Measures a fcontext_swap round-trip (switch to a context and back).
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_fcontext_swap(t_bench *bench)
+{
+	uint64_t i;
+
+	fcontext_task.stack.sp = fcontext_stack;
+	fcontext_task.stack.size = sizeof(fcontext_stack);
+	fcontext_task.link = &fcontext_main;
+	fcontext(&fcontext_task, bench_fcontext_func, NULL);
+	bench_start(bench);
+	for (i = 0; i < bench->iterations; i++) {
+		fcontext_swap(&fcontext_main, &fcontext_task);
+	}
+	bench_stop(bench);
+}
+
+static void bench_task_empty(void *unused(arg))
+{
+}
+
+/**
+ * Measures task creation, execution and destruction.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_task_start(t_bench *bench)
+{
+	uint64_t i;
+	uint64_t j;
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	if (sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		return;
+	}
+	bench_start(bench);
+	for (i = 0; i < bench->iterations; i += BENCH_TASK_BATCH) {
+		for (j = 0; j < BENCH_TASK_BATCH; j++) {
+			if (rinoo_task_start(sched, bench_task_empty, NULL) != 0) {
+				bench_fail(bench, "rinoo_task_start failed");
+				rinoo_sched_destroy(sched);
+				return;
+			}
+		}
+		rinoo_sched_loop(sched);
+	}
+	bench_stop(bench);
+	rinoo_sched_destroy(sched);
+}
+
+typedef struct s_bench_yield {
+	t_sched *sched;
+	uint64_t count;
+} t_bench_yield;
+
+static void bench_task_yielder(void *arg)
+{
+	uint64_t i;
+	t_bench_yield *yield = arg;
+
+	for (i = 0; i < yield->count; i++) {
+		rinoo_task_pause(yield->sched);
+	}
+}
+
+/**
+ * Measures task yield throughput with two tasks yielding to each other.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_task_yield(t_bench *bench)
+{
+	t_bench_yield yield;
+
+	yield.sched = rinoo_sched();
+	if (yield.sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		return;
+	}
+	yield.count = bench->iterations / 2;
+	if (rinoo_task_start(yield.sched, bench_task_yielder, &yield) != 0 ||
+	    rinoo_task_start(yield.sched, bench_task_yielder, &yield) != 0) {
+		bench_fail(bench, "rinoo_task_start failed");
+		rinoo_sched_destroy(yield.sched);
+		return;
+	}
+	bench_start(bench);
+	rinoo_sched_loop(yield.sched);
+	bench_stop(bench);
+	rinoo_sched_destroy(yield.sched);
+}
+
+typedef struct s_bench_timer {
+	uint64_t time;
+	t_rbtree_node node;
+} t_bench_timer;
+
+/**
+ * Orders timers the way the scheduler orders its task timers.
+ */
+static int bench_timer_cmp(t_rbtree_node *node1, t_rbtree_node *node2)
+{
+	t_bench_timer *timer1 = container_of(node1, t_bench_timer, node);
+	t_bench_timer *timer2 = container_of(node2, t_bench_timer, node);
+
+	if (timer1 == timer2) {
+		return 0;
+	}
+	if (timer1->time < timer2->time) {
+		return -1;
+	}
+	return 1;
+}
+
+/**
+ * Measures arming and cancelling a timer while 1M timers are pending.
+ * Tasks carry their stack inline, so 1M of them do not fit in memory: this
+ * uses a standalone timer tree, built like the scheduler one.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_timer_arm_cancel(t_bench *bench)
+{
+	uint64_t i;
+	t_rbtree tree;
+	t_bench_timer *timer;
+	t_bench_timer *timers;
+
+	if (rbtree(&tree, bench_timer_cmp, NULL) != 0) {
+		bench_fail(bench, "rbtree failed");
+		return;
+	}
+	timers = calloc(BENCH_PENDING_TIMERS + 1, sizeof(*timers));
+	if (timers == NULL) {
+		bench_fail(bench, "calloc failed");
+		return;
+	}
+	for (i = 0; i < BENCH_PENDING_TIMERS; i++) {
+		timers[i].time = i * RINOO_NSEC_PER_USEC;
+		rbtree_put(&tree, &timers[i].node);
+	}
+	timer = &timers[BENCH_PENDING_TIMERS];
+	bench_start(bench);
+	for (i = 0; i < bench->iterations; i++) {
+		/* Deterministic spread of deadlines among pending timers */
+		timer->time = ((i * 7919) % BENCH_PENDING_TIMERS) * RINOO_NSEC_PER_USEC;
+		rbtree_put(&tree, &timer->node);
+		rbtree_remove(&tree, &timer->node);
+	}
+	bench_stop(bench);
+	free(timers);
+}
+
+typedef struct s_bench_channel {
+	t_channel *channel;
+	uint64_t count;
+} t_bench_channel;
+
+static void bench_channel_ping(void *arg)
+{
+	uint64_t i;
+	uint64_t x;
+	t_bench_channel *bench = arg;
+
+	for (i = 0; i < bench->count; i++) {
+		rinoo_channel_write(bench->channel, &i, sizeof(i));
+		rinoo_channel_read(bench->channel, &x, sizeof(x));
+	}
+}
+
+static void bench_channel_pong(void *arg)
+{
+	uint64_t i;
+	uint64_t x;
+	t_bench_channel *bench = arg;
+
+	for (i = 0; i < bench->count; i++) {
+		rinoo_channel_read(bench->channel, &x, sizeof(x));
+		rinoo_channel_write(bench->channel, &x, sizeof(x));
+	}
+}
+
+/**
+ * Measures a channel ping-pong round-trip between two tasks.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_channel_pingpong(t_bench *bench)
+{
+	t_sched *sched;
+	t_bench_channel channel;
+
+	sched = rinoo_sched();
+	if (sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		return;
+	}
+	channel.count = bench->iterations;
+	channel.channel = rinoo_channel(sched);
+	if (channel.channel == NULL ||
+	    rinoo_task_start(sched, bench_channel_ping, &channel) != 0 ||
+	    rinoo_task_start(sched, bench_channel_pong, &channel) != 0) {
+		bench_fail(bench, "channel setup failed");
+		rinoo_sched_destroy(sched);
+		return;
+	}
+	bench_start(bench);
+	rinoo_sched_loop(sched);
+	bench_stop(bench);
+	rinoo_channel_destroy(channel.channel);
+	rinoo_sched_destroy(sched);
+}
+
+typedef struct s_bench_waitfor {
+	t_sched_node node;
+	uint64_t count;
+	bool failed;
+} t_bench_waitfor;
+
+static int bench_waitfor_read(t_sched_node *node)
+{
+	char c;
+
+	while (read(node->fd, &c, 1) != 1) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_sched_waitfor(node, RINOO_MODE_IN) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void bench_waitfor_ping(void *arg)
+{
+	uint64_t i;
+	t_bench_waitfor *bench = arg;
+
+	for (i = 0; i < bench->count; i++) {
+		if (write(bench->node.fd, "x", 1) != 1 || bench_waitfor_read(&bench->node) != 0) {
+			bench->failed = true;
+			return;
+		}
+	}
+}
+
+static void bench_waitfor_pong(void *arg)
+{
+	uint64_t i;
+	t_bench_waitfor *bench = arg;
+
+	for (i = 0; i < bench->count; i++) {
+		if (bench_waitfor_read(&bench->node) != 0 || write(bench->node.fd, "x", 1) != 1) {
+			bench->failed = true;
+			return;
+		}
+	}
+}
+
+/**
+ * Measures a ping-pong round-trip on a socketpair through rinoo_sched_waitfor.
+ *
+ * @param bench Pointer to the benchmark
+ */
+void bench_sched_waitfor(t_bench *bench)
+{
+	int i;
+	int fds[2];
+	t_sched *sched;
+	t_bench_waitfor ends[2];
+
+	sched = rinoo_sched();
+	if (sched == NULL) {
+		bench_fail(bench, "rinoo_sched failed");
+		return;
+	}
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0) {
+		bench_fail(bench, "socketpair failed");
+		rinoo_sched_destroy(sched);
+		return;
+	}
+	memset(ends, 0, sizeof(ends));
+	for (i = 0; i < 2; i++) {
+		ends[i].node.fd = fds[i];
+		ends[i].node.sched = sched;
+		ends[i].count = bench->iterations;
+	}
+	rinoo_task_start(sched, bench_waitfor_ping, &ends[0]);
+	rinoo_task_start(sched, bench_waitfor_pong, &ends[1]);
+	bench_start(bench);
+	rinoo_sched_loop(sched);
+	bench_stop(bench);
+	for (i = 0; i < 2; i++) {
+		if (ends[i].failed) {
+			bench_fail(bench, "socketpair I/O failed");
+		}
+		rinoo_sched_remove(&ends[i].node);
+		close(fds[i]);
+	}
+	rinoo_sched_destroy(sched);
+}
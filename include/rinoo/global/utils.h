@@ -15,6 +15,10 @@
 
 #define RINOO_LOG_MAXLENGTH	2048
 
+#define RINOO_NSEC_PER_USEC	1000ULL
+#define RINOO_NSEC_PER_MSEC	1000000ULL
+#define RINOO_NSEC_PER_SEC	1000000000ULL
+
 void rinoo_log(const char *format, ...);
 
 #endif /* !RINOO_UTILS_H_ */
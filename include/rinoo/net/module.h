@@ -13,20 +13,36 @@
 
 #define _GNU_SOURCE
 
+#include <time.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <limits.h>
 #include <string.h>
+#include <stddef.h>
 #include <sys/uio.h>
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/ioctl.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <sys/sendfile.h>
+#include <netinet/tcp.h>
+#include <netinet/udp.h>
+#include <linux/filter.h>
+#include <linux/errqueue.h>
 #include <openssl/ssl.h>
 #include <openssl/pem.h>
 #include <openssl/conf.h>
 #include <openssl/x509v3.h>
+#include <openssl/err.h>
+#include <openssl/rand.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#endif
 
 #include "rinoo/global/module.h"
 #include "rinoo/memory/module.h"
@@ -38,8 +54,12 @@
 #include "rinoo/net/socket_class_tcp.h"
 #include "rinoo/net/socket_class_udp.h"
 #include "rinoo/net/socket_class_ssl.h"
+#include "rinoo/net/socket_class_unix.h"
 #include "rinoo/net/tcp.h"
 #include "rinoo/net/udp.h"
+#include "rinoo/net/unix.h"
 #include "rinoo/net/ssl.h"
+#include "rinoo/net/ssl_offload.h"
+#include "rinoo/net/pool.h"
 
 #endif /* !RINOO_MODULE_NET_H_ */
@@ -0,0 +1,68 @@
+/**
+ * @file   pool.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 17:48:12 2026
+ *
+ * @brief  Header file for client connection pool functions.
+ *
+ *
+ */
+
+#ifndef RINOO_NET_POOL_H_
+#define RINOO_NET_POOL_H_
+
+#define RINOO_POOL_HTABLE_SIZE	64
+
+typedef struct s_socket_pool_config {
+	uint32_t max_idle;		/* Idle connections kept per endpoint */
+	uint32_t max_per_endpoint;	/* Acquired and idle connections per endpoint, 0 for no limit */
+	uint32_t idle_timeout;		/* Milliseconds before closing idle connections, 0 for none */
+	uint32_t timeout;		/* Connect and limit wait timeout in milliseconds, 0 for none */
+	int (*check)(t_socket *socket);	/* Health check on reuse, NULL for rinoo_socket_pool_check */
+} t_socket_pool_config;
+
+typedef struct s_socket_pool_stats {
+	uint64_t created;
+	uint64_t reused;
+	uint64_t expired;
+	uint64_t unhealthy;
+	uint64_t waited;
+} t_socket_pool_stats;
+
+typedef struct s_socket_pool_key {
+	t_ip ip;
+	t_ssl_ctx *ctx;
+} t_socket_pool_key;
+
+typedef struct s_socket_pool_endpoint {
+	t_socket_pool_key key;
+	uint32_t nbconns;
+	t_list idle;
+	t_list waiters;
+	t_htable_node node;
+} t_socket_pool_endpoint;
+
+typedef struct s_socket_pool_conn {
+	t_socket *socket;
+	uint64_t idle_since;
+	t_socket_pool_endpoint *endpoint;
+	t_list_node lnode;
+	t_htable_node hnode;
+} t_socket_pool_conn;
+
+typedef struct s_socket_pool {
+	t_sched *sched;
+	t_socket_pool_config config;
+	t_socket_pool_stats stats;
+	t_htable endpoints;
+	t_htable conns;
+} t_socket_pool;
+
+t_socket_pool *rinoo_socket_pool(t_sched *sched, const t_socket_pool_config *config);
+void rinoo_socket_pool_destroy(t_socket_pool *pool);
+t_socket *rinoo_socket_pool_acquire(t_socket_pool *pool, t_ip *ip, uint16_t port, t_ssl_ctx *ctx);
+void rinoo_socket_pool_release(t_socket_pool *pool, t_socket *socket);
+void rinoo_socket_pool_discard(t_socket_pool *pool, t_socket *socket);
+int rinoo_socket_pool_check(t_socket *socket);
+
+#endif /* !RINOO_NET_POOL_H_ */
@@ -12,10 +12,62 @@
 #define RINOO_NET_SOCKET_H_
 
 #define MAX_IO_CALLS	10
+/* Datagrams moved per recvmmsg/sendmmsg syscall, headers live on the task stack */
+#define RINOO_SOCKET_MMSG_MAX	32
+/* Chunk forwarded per call when splice(2) cannot be used */
+#define RINOO_SOCKET_SPLICE_COPY_SIZE	16384
+
+typedef struct s_socket_zerocopy {
+	size_t threshold;	/* 0 when disabled */
+	uint32_t sent;		/* Number of zerocopy sends */
+	uint32_t completed;	/* Number of sends released by the kernel */
+	uint32_t copied;	/* Number of completions where the kernel copied anyway */
+} t_socket_zerocopy;
+
+typedef struct s_socket_readahead {
+	char *buf;
+	size_t size;		/* 0 when disabled */
+	size_t start;		/* First unread byte */
+	size_t end;		/* End of buffered data */
+} t_socket_readahead;
+
+typedef struct s_socket_coalesce {
+	char *buf;
+	size_t size;		/* 0 when disabled */
+	size_t len;		/* Pending bytes */
+	bool flushing;
+	uint64_t writes;	/* Writes stored in the buffer */
+	uint64_t flushes;	/* Syscalls used to send them */
+	t_task_flush flush;
+} t_socket_coalesce;
+
+typedef enum e_socket_option {
+	RINOO_SOCKET_NODELAY = 0,	/* TCP_NODELAY, boolean */
+	RINOO_SOCKET_SNDBUF,		/* SO_SNDBUF, bytes */
+	RINOO_SOCKET_RCVBUF,		/* SO_RCVBUF, bytes */
+	RINOO_SOCKET_QUICKACK,		/* TCP_QUICKACK, boolean, the kernel may reset it */
+	RINOO_SOCKET_NOTSENT_LOWAT,	/* TCP_NOTSENT_LOWAT, bytes */
+	RINOO_SOCKET_BUSY_POLL,		/* SO_BUSY_POLL, microseconds */
+	RINOO_SOCKET_TOS,		/* IP_TOS or IPV6_TCLASS */
+	RINOO_SOCKET_KEEPALIVE,		/* SO_KEEPALIVE, boolean */
+	RINOO_SOCKET_KEEPIDLE,		/* TCP_KEEPIDLE, seconds */
+	RINOO_SOCKET_KEEPINTVL,		/* TCP_KEEPINTVL, seconds */
+	RINOO_SOCKET_KEEPCNT,		/* TCP_KEEPCNT, probes */
+	RINOO_SOCKET_OPTION_MAX
+} t_socket_option;
+
+typedef struct s_socket_options {
+	uint32_t set;		/* Mask of options to apply */
+	int values[RINOO_SOCKET_OPTION_MAX];
+} t_socket_options;
 
 typedef struct s_socket {
 	int io_calls;
 	t_sched_node node;
+	t_socket_zerocopy zerocopy;
+	t_socket_readahead readahead;
+	t_socket_coalesce coalesce;
+	t_socket_options *defaults;	/* Options inherited by accepted sockets */
 	struct s_socket *parent;
 	const t_socket_class *class;
 } t_socket;
@@ -25,6 +77,12 @@ typedef union u_ip {
 	struct sockaddr_in6 v6;
 } t_ip;
 
+typedef struct s_socket_msg {
+	t_buffer *buffer;
+	t_ip addr;
+	socklen_t addrlen;
+} t_socket_msg;
+
 #define IP_ANY		(NULL)
 #define IP_LOOPBACK	(NULL)
 #define IS_IPV4(ip)	(ip->v4.sin_family == AF_INET)
@@ -42,19 +100,35 @@ int rinoo_socket_waitin(t_socket *socket);
 int rinoo_socket_waitout(t_socket *socket);
 int rinoo_socket_waitio(t_socket *socket);
 int rinoo_socket_timeout(t_socket *socket, uint32_t ms);
+int rinoo_socket_timeout_ns(t_socket *socket, uint64_t ns);
+int rinoo_socket_zerocopy(t_socket *socket, size_t threshold);
+int rinoo_socket_zerocopy_wait(t_socket *socket);
+int rinoo_socket_set_option(t_socket *socket, t_socket_option option, int value);
+int rinoo_socket_get_option(t_socket *socket, t_socket_option option, int *value);
+int rinoo_socket_set_default(t_socket *socket, t_socket_option option, int value);
+int rinoo_socket_inherit(t_socket *socket, t_socket *listener);
 
 int rinoo_socket_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
 int rinoo_socket_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
 t_socket *rinoo_socket_accept(t_socket *socket, struct sockaddr *addr, socklen_t *addrlen);
 ssize_t rinoo_socket_read(t_socket *socket, void *buf, size_t count);
+int rinoo_socket_readahead(t_socket *socket, size_t size);
+void *rinoo_socket_peek(t_socket *socket, size_t count);
+int rinoo_socket_consume(t_socket *socket, size_t count);
+ssize_t rinoo_socket_read_exact(t_socket *socket, void *buf, size_t count);
+int rinoo_socket_coalesce(t_socket *socket, size_t size);
+int rinoo_socket_flush(t_socket *socket);
 ssize_t rinoo_socket_recvfrom(t_socket *socket, void *buf, size_t count, struct sockaddr *addrfrom, socklen_t *addrlen);
 ssize_t rinoo_socket_write(t_socket *socket, const void *buf, size_t count);
 ssize_t rinoo_socket_writev(t_socket *socket, t_buffer **buffers, int count);
 ssize_t rinoo_socket_sendto(t_socket *socket, void *buf, size_t count, const struct sockaddr *addrto, socklen_t addrlen);
+int rinoo_socket_recvmmsg(t_socket *socket, t_socket_msg *msgs, int count);
+int rinoo_socket_sendmmsg(t_socket *socket, t_socket_msg *msgs, int count);
 ssize_t rinoo_socket_readb(t_socket *socket, t_buffer *buffer);
 ssize_t rinoo_socket_readline(t_socket *socket, t_buffer *buffer, const char *delim, size_t maxsize);
 ssize_t rinoo_socket_expect(t_socket *socket, t_buffer *buffer, const char *expected);
 ssize_t rinoo_socket_writeb(t_socket *socket, t_buffer *buffer);
 ssize_t rinoo_socket_sendfile(t_socket *socket, int in_fd, off_t offset, size_t count);
+ssize_t rinoo_socket_splice(t_socket *in, t_socket *out, size_t len);
 
 #endif /* !RINOO_NET_SOCKET */
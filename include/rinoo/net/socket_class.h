@@ -12,6 +12,7 @@
 #define RINOO_NET_SOCKET_CLASS_H_
 
 struct s_socket;
+struct s_socket_msg;
 
 typedef struct s_socket_class {
 	int domain;
@@ -27,6 +28,8 @@ typedef struct s_socket_class {
 	ssize_t (*writev)(struct s_socket *socket, t_buffer **buffers, int count);
 	ssize_t (*sendto)(struct s_socket *socket, void *buf, size_t count, const struct sockaddr *addrto, socklen_t addrlen);
 	ssize_t (*sendfile)(struct s_socket *socket, int in_fd, off_t offset, size_t count);
+	int (*recvmmsg)(struct s_socket *socket, struct s_socket_msg *msgs, int count);
+	int (*sendmmsg)(struct s_socket *socket, struct s_socket_msg *msgs, int count);
 	int (*connect)(struct s_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
 	int (*bind)(struct s_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
 	struct s_socket *(*accept)(struct s_socket *socket, struct sockaddr *addr, socklen_t *addrlen);
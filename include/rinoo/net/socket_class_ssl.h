@@ -13,8 +13,11 @@
 
 t_socket *rinoo_socket_class_ssl_create(t_sched *sched);
 void rinoo_socket_class_ssl_destroy(t_socket *socket);
+int rinoo_socket_class_ssl_close(t_socket *socket);
 ssize_t rinoo_socket_class_ssl_read(t_socket *socket, void *buf, size_t count);
 ssize_t	rinoo_socket_class_ssl_write(t_socket *socket, const void *buf, size_t count);
+ssize_t rinoo_socket_class_ssl_writev(t_socket *socket, t_buffer **buffers, int count);
+ssize_t rinoo_socket_class_ssl_sendfile(t_socket *socket, int in_fd, off_t offset, size_t count);
 int rinoo_socket_class_ssl_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
 t_socket *rinoo_socket_class_ssl_accept(t_socket *socket, struct sockaddr *addr, socklen_t *addrlen);
 
@@ -25,5 +25,6 @@ ssize_t rinoo_socket_class_tcp_sendfile(t_socket *socket, int in_fd, off_t offse
 int rinoo_socket_class_tcp_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
 int rinoo_socket_class_tcp_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
 t_socket *rinoo_socket_class_tcp_accept(t_socket *socket, struct sockaddr *addr, socklen_t *addrlen);
+int rinoo_socket_class_tcp_accept_many(t_socket *socket, t_socket **sockets, int count);
 
 #endif /* !RINOO_NET_SOCKET_CLASS_TCP_H_ */
@@ -21,6 +21,8 @@ ssize_t rinoo_socket_class_udp_recvfrom(t_socket *socket, void *buf, size_t coun
 ssize_t rinoo_socket_class_udp_write(t_socket *socket, const void *buf, size_t count);
 ssize_t rinoo_socket_class_udp_writev(t_socket *socket, t_buffer **buffers, int count);
 ssize_t rinoo_socket_class_udp_sendto(t_socket *socket, void *buf, size_t count, const struct sockaddr *addrto, socklen_t addrlen);
+int rinoo_socket_class_udp_recvmmsg(t_socket *socket, t_socket_msg *msgs, int count);
+int rinoo_socket_class_udp_sendmmsg(t_socket *socket, t_socket_msg *msgs, int count);
 ssize_t rinoo_socket_class_udp_sendfile(t_socket *socket, int in_fd, off_t offset, size_t count);
 int rinoo_socket_class_udp_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
 int rinoo_socket_class_udp_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
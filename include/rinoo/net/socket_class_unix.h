@@ -0,0 +1,17 @@
+/**
+ * @file   socket_class_unix.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 20:14:37 2026
+ *
+ * @brief  Unix domain socket classes
+ *
+ *
+ */
+
+#ifndef RINOO_NET_SOCKET_CLASS_UNIX_H_
+#define RINOO_NET_SOCKET_CLASS_UNIX_H_
+
+int rinoo_socket_class_unix_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
+int rinoo_socket_class_unix_dgram_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog);
+
+#endif /* !RINOO_NET_SOCKET_CLASS_UNIX_H_ */
@@ -11,21 +11,92 @@
 #ifndef RINOO_NET_SSL_H_
 #define RINOO_NET_SSL_H_
 
+/* Maximum TLS record payload */
+#define RINOO_SSL_RECORD_SIZE	16384
+
+/* Memory BIO ring buffer size per direction */
+#define RINOO_SSL_MEMBIO_SIZE	32768
+
+/* Idle time in milliseconds before memory BIO ring buffers are released */
+#define RINOO_SSL_MEMBIO_IDLE	100
+
+#define RINOO_SSL_SESSIONS_HTABLE_SIZE	64
+#define RINOO_SSL_CONTEXTS_HTABLE_SIZE	16
+
+/* Kernel TLS is driven by OpenSSL 3.0 and later */
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(OPENSSL_NO_KTLS)
+#define RINOO_SSL_KTLS
+#endif
+
+/* Default key exchange groups */
+#define RINOO_SSL_GROUPS	"X25519:P-256"
+
+typedef struct s_ssl_options {
+	bool tls13_only;		/* TLS 1.3 only, otherwise TLS 1.2 and later */
+	const char *ciphers;		/* TLS 1.2 cipher list, NULL for OpenSSL defaults */
+	const char *ciphersuites;	/* TLS 1.3 cipher suites, NULL for OpenSSL defaults */
+	const char *groups;		/* Key exchange groups, NULL for RINOO_SSL_GROUPS */
+} t_ssl_options;
+
+typedef struct s_ssl_ticket_key {
+	unsigned char name[16];
+	unsigned char aes[32];
+	unsigned char hmac[32];
+	time_t created;
+} t_ssl_ticket_key;
+
+typedef struct s_ssl_session_stats {
+	uint64_t hits;		/* Server handshakes resuming a session */
+	uint64_t misses;	/* Server full handshakes */
+	uint64_t resumed;	/* Client handshakes resuming a session */
+	uint64_t full;		/* Client full handshakes */
+} t_ssl_session_stats;
+
+/* Defined in ssl_offload.h */
+struct s_ssl_offload;
+
 typedef struct s_ssl_ctx {
 	X509 *x509;
 	EVP_PKEY *pkey;
 	SSL_CTX *ctx;
+	pthread_mutex_t mutex;
+	uint32_t rotation;		/* Ticket key rotation period in seconds */
+	t_ssl_ticket_key keys[2];	/* Current and previous ticket keys */
+	uint32_t sessions_max;		/* Client sessions kept, 0 when disabled */
+	t_htable sessions;		/* Client sessions per destination */
+	t_ssl_session_stats stats;
+	struct s_ssl_offload *offload;	/* Handshake workers, NULL to handshake inline */
+	size_t membio;			/* Memory BIO ring buffer size, 0 for socket BIOs */
+	char *id;			/* Cache key of contexts loaded from files */
+	uint32_t refs;
+	t_htable_node node;
 } t_ssl_ctx;
 
 typedef struct s_ssl {
 	SSL *ssl;
 	t_ssl_ctx *ctx;
+	char *staging;		/* Record staging buffer used by writev */
+	bool ktls_send;		/* Records are encrypted by the kernel */
+	t_ip peer;		/* Destination used for client session resumption */
+	BIO *network;		/* Socket side of the memory BIO pair */
 	t_socket socket;
 } t_ssl;
 
 t_ssl_ctx *rinoo_ssl_context(void);
+t_ssl_ctx *rinoo_ssl_context_ecdsa(void);
+t_ssl_ctx *rinoo_ssl_context_from_files(const char *cert, const char *key, const t_ssl_options *options);
 void rinoo_ssl_context_destroy(t_ssl_ctx *ctx);
+int rinoo_ssl_context_ktls(t_ssl_ctx *ctx, bool enabled);
+int rinoo_ssl_context_offload(t_ssl_ctx *ctx, int threads);
+int rinoo_ssl_context_membio(t_ssl_ctx *ctx, size_t size);
+bool rinoo_ssl_ktls(t_socket *socket);
+int rinoo_ssl_check(t_socket *socket);
+int rinoo_ssl_context_session_cache(t_ssl_ctx *ctx, uint32_t size, uint32_t timeout);
+int rinoo_ssl_context_tickets(t_ssl_ctx *ctx, uint32_t rotation);
+void rinoo_ssl_context_stats(t_ssl_ctx *ctx, t_ssl_session_stats *stats);
 t_ssl *rinoo_ssl_get(t_socket *socket);
+void rinoo_ssl_session_resume(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen);
+void rinoo_ssl_session_count(t_socket *socket);
 t_socket *rinoo_ssl_client(t_sched *sched, t_ssl_ctx *ctx, t_ip *ip, uint32_t port, uint32_t timeout);
 t_socket *rinoo_ssl_server(t_sched *sched, t_ssl_ctx *ctx, t_ip *ip, uint32_t port);
 t_socket *rinoo_ssl_accept(t_socket *socket, t_ip *fromip, uint32_t *fromport);
@@ -0,0 +1,40 @@
+/**
+ * @file   ssl_offload.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Mon Oct 19 00:24:37 2026
+ *
+ * @brief  Header file for TLS handshake offloading function declarations
+ *
+ * Handshake steps run on worker threads while the calling task is parked,
+ * so that private key operations do not stall the scheduler.
+ *
+ */
+
+#ifndef RINOO_NET_SSL_OFFLOAD_H_
+#define RINOO_NET_SSL_OFFLOAD_H_
+
+typedef struct s_ssl_offload_job {
+	SSL *ssl;
+	int ret;
+	int error;
+	t_sched_node node;	/* eventfd signaled once a step is done, kept for the whole handshake */
+	t_list_node lnode;
+} t_ssl_offload_job;
+
+typedef struct s_ssl_offload {
+	int count;
+	bool stop;
+	pthread_t *threads;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	t_list jobs;
+	uint64_t steps;		/* Handshake steps run by workers */
+} t_ssl_offload;
+
+t_ssl_offload *rinoo_ssl_offload(int count);
+void rinoo_ssl_offload_destroy(t_ssl_offload *offload);
+int rinoo_ssl_offload_job(t_ssl_offload_job *job, t_sched *sched, SSL *ssl);
+void rinoo_ssl_offload_job_destroy(t_ssl_offload_job *job);
+int rinoo_ssl_offload_handshake(t_ssl_offload *offload, t_ssl_offload_job *job, int *error);
+
+#endif /* !RINOO_NET_SSL_OFFLOAD_H_ */
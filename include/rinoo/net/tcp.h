@@ -12,9 +12,45 @@
 #define RINOO_NET_TCP_H_
 
 #define RINOO_TCP_BACKLOG	128
+/* Connections accepted per rinoo_tcp_accept_many call by spawned servers */
+#define RINOO_TCP_ACCEPT_BATCH	32
+/* Delay between staggered connection attempts of rinoo_tcp_client_multi (RFC 8305) */
+#define RINOO_TCP_ATTEMPT_DELAY	250
+
+typedef struct s_tcp_listen_options {
+	int backlog;		/* 0 for RINOO_TCP_BACKLOG */
+	uint32_t defer_accept;	/* Seconds to wait for data before accepting, 0 to disable */
+	int fastopen;		/* TCP Fast Open queue length, 0 to disable */
+} t_tcp_listen_options;
+
+struct s_tcp_spawned;
+
+typedef struct s_tcp_spawned_listener {
+	int id;
+	t_sched *sched;
+	t_socket *socket;
+	uint64_t accepted;
+	struct s_tcp_spawned *server;
+} t_tcp_spawned_listener;
+
+typedef struct s_tcp_spawned {
+	int count;
+	bool steering;
+	uint64_t start;
+	void (*handler)(void *socket);
+	t_tcp_spawned_listener *listeners;
+} t_tcp_spawned;
 
 t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout);
+t_socket *rinoo_tcp_client_fastopen(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout);
+t_socket *rinoo_tcp_client_multi(t_sched *sched, t_ip *ips, int n, uint16_t port, uint32_t timeout);
 t_socket *rinoo_tcp_server(t_sched *sched, t_ip *ip, uint16_t port);
+t_socket *rinoo_tcp_server_options(t_sched *sched, t_ip *ip, uint16_t port, const t_tcp_listen_options *options);
 t_socket *rinoo_tcp_accept(t_socket *socket, t_ip *fromip, uint16_t *fromport);
+int rinoo_tcp_accept_many(t_socket *socket, t_socket **clients, int count);
+t_tcp_spawned *rinoo_tcp_server_spawned(t_sched *sched, t_ip *ip, uint16_t port, void (*handler)(void *socket));
+int rinoo_tcp_server_spawned_steer(t_tcp_spawned *server);
+void rinoo_tcp_server_spawned_report(t_tcp_spawned *server);
+void rinoo_tcp_server_spawned_destroy(t_tcp_spawned *server);
 
 #endif /* !RINOO_NET_TCP_H_ */
@@ -11,6 +11,16 @@
 #ifndef RINOO_NET_UDP_H_
 #define RINOO_NET_UDP_H_
 
+/* Kernel limits for one UDP_SEGMENT send */
+#define RINOO_UDP_GSO_MAX_SEGMENTS	64
+#define RINOO_UDP_GSO_MAX_SIZE		65507
+/* Size of a receive buffer able to hold any coalesced GRO datagram */
+#define RINOO_UDP_GRO_BUFFER_SIZE	65535
+
 t_socket *rinoo_udp_client(t_sched *sched, t_ip *ip, uint16_t port);
+ssize_t rinoo_udp_sendgso(t_socket *socket, const void *buf, size_t count, uint16_t segsize, const struct sockaddr *addrto, socklen_t addrlen);
+int rinoo_udp_gro(t_socket *socket, bool enabled);
+ssize_t rinoo_udp_recvgro(t_socket *socket, t_buffer *buffer, uint16_t *segsize, struct sockaddr *addrfrom, socklen_t *addrlen);
+int rinoo_udp_segment(t_buffer *buffer, uint16_t segsize, unsigned int index, t_buffer *view);
 
 #endif /* !RINOO_NET_UDP_H_ */
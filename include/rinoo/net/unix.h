@@ -0,0 +1,27 @@
+/**
+ * @file   unix.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 20:21:44 2026
+ *
+ * @brief  Header file for unix domain socket function declarations
+ *
+ * Paths starting with '@' are bound in the Linux abstract namespace.
+ *
+ */
+
+#ifndef RINOO_NET_UNIX_H_
+#define RINOO_NET_UNIX_H_
+
+#define RINOO_UNIX_BACKLOG	128
+/* File descriptors passed per rinoo_unix_sendfds/recvfds call */
+#define RINOO_UNIX_FDS_MAX	16
+
+t_socket *rinoo_unix_client(t_sched *sched, const char *path, uint32_t timeout);
+t_socket *rinoo_unix_server(t_sched *sched, const char *path);
+t_socket *rinoo_unix_accept(t_socket *socket);
+t_socket *rinoo_unix_dgram_client(t_sched *sched, const char *path);
+t_socket *rinoo_unix_dgram_server(t_sched *sched, const char *path);
+int rinoo_unix_sendfds(t_socket *socket, const int *fds, int count);
+int rinoo_unix_recvfds(t_socket *socket, int *fds, int count);
+
+#endif /* !RINOO_NET_UNIX_H_ */
@@ -30,6 +30,6 @@ void rinoo_epoll_destroy(struct s_sched *sched);
 int rinoo_epoll_insert(struct s_sched_node *node, enum e_sched_mode mode);
 int rinoo_epoll_addmode(struct s_sched_node *node, enum e_sched_mode mode);
 int rinoo_epoll_remove(struct s_sched_node *node);
-int rinoo_epoll_poll(struct s_sched *sched, int timeout);
+int rinoo_epoll_poll(struct s_sched *sched, int64_t timeout);
 
 #endif /* !RINOO_RINOO_EPOLL_H_ */
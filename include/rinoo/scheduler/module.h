@@ -12,12 +12,17 @@
 #define RINOO_MODULE_SCHEDULER_H_
 
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <signal.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
 
 #include "rinoo/debug/module.h"
 #include "rinoo/global/module.h"
@@ -27,7 +32,10 @@
 #include "rinoo/scheduler/task.h"
 #include "rinoo/scheduler/node.h"
 #include "rinoo/scheduler/epoll.h"
+#include "rinoo/scheduler/signal.h"
 #include "rinoo/scheduler/spawn.h"
+#include "rinoo/scheduler/pipe.h"
+#include "rinoo/scheduler/slab.h"
 #include "rinoo/scheduler/scheduler.h"
 #include "rinoo/scheduler/channel.h"
 
@@ -18,11 +18,13 @@ typedef enum e_sched_mode {
 	RINOO_MODE_NONE = 0,
 	RINOO_MODE_IN = 1,
 	RINOO_MODE_OUT = 2,
+	RINOO_MODE_ERR = 4,
 } t_sched_mode;
 
 typedef struct s_sched_node {
 	int fd;
 	int error;
+	bool errqueue;
 	t_task *task;
 	t_list_node lnode;
 	t_sched_mode mode;
@@ -0,0 +1,28 @@
+/**
+ * @file   pipe.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 19:31:48 2026
+ *
+ * @brief  Scheduler pipe pool
+ *
+ *
+ */
+
+#ifndef RINOO_SCHEDULER_PIPE_H_
+#define RINOO_SCHEDULER_PIPE_H_
+
+#define RINOO_SCHED_PIPES_MAX	16
+
+/* Defined in scheduler.h */
+struct s_sched;
+
+typedef struct s_sched_pipes {
+	int count;
+	int fds[RINOO_SCHED_PIPES_MAX][2];
+} t_sched_pipes;
+
+int rinoo_pipe_get(struct s_sched *sched, int fds[2]);
+void rinoo_pipe_release(struct s_sched *sched, int fds[2], bool empty);
+void rinoo_pipe_destroy(struct s_sched *sched);
+
+#endif /* !RINOO_SCHEDULER_PIPE_H_ */
@@ -16,10 +16,14 @@ typedef struct s_sched {
 	bool stop;
 	t_list nodes;
 	uint32_t nbpending;
-	struct timeval clock;
+	uint64_t clock;
+	uint64_t dropped;	/* Coalesced bytes dropped on close */
 	t_task_driver driver;
 	struct s_epoll epoll;
+	t_signal signal;
 	t_sched_spawns spawns;
+	t_sched_pipes pipes;
+	t_sched_slabs slabs;
 } t_sched;
 
 t_sched *rinoo_sched(void);
@@ -0,0 +1,27 @@
+/**
+ * @file   signal.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 12:50:11 2026
+ *
+ * @brief  Header file for scheduler signal functions.
+ *
+ *
+ */
+
+#ifndef RINOO_SCHEDULER_SIGNAL_H_
+#define RINOO_SCHEDULER_SIGNAL_H_
+
+/* Defined in scheduler.h */
+struct s_sched;
+
+typedef struct s_signal {
+	t_sched_node node;
+	struct signalfd_siginfo info;
+} t_signal;
+
+void rinoo_signal_init(struct s_sched *sched);
+void rinoo_signal_destroy(struct s_sched *sched);
+int rinoo_signal_wait(struct s_sched *sched, const sigset_t *mask);
+struct signalfd_siginfo *rinoo_signal_info(struct s_sched *sched);
+
+#endif /* !RINOO_SCHEDULER_SIGNAL_H_ */
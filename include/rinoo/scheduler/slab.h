@@ -0,0 +1,55 @@
+/**
+ * @file   slab.h
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 22:05:19 2026
+ *
+ * @brief  Scheduler object slabs
+ *
+ *
+ */
+
+#ifndef RINOO_SCHEDULER_SLAB_H_
+#define RINOO_SCHEDULER_SLAB_H_
+
+/* Object sizes served per scheduler, others fall back to malloc */
+#define RINOO_SCHED_SLABS	4
+/* Objects allocated at once when a slab is empty */
+#define RINOO_SLAB_CHUNK	64
+/* Objects held by a slab, allocations beyond fall back to malloc */
+#define RINOO_SLAB_MAX		65536
+
+/* Defined in scheduler.h */
+struct s_sched;
+
+typedef struct s_slab_stats {
+	size_t size;		/* Object size, 0 if the slab is unused */
+	uint32_t capacity;	/* Objects allocated by chunks */
+	uint32_t used;		/* Objects in use */
+	uint64_t allocs;	/* Allocations served by the slab */
+	uint64_t fallbacks;	/* Allocations served by malloc as the slab was full */
+} t_slab_stats;
+
+typedef struct s_slab_object {
+	struct s_slab *slab;		/* NULL when allocated by malloc */
+	struct s_slab_object *next;	/* Next free object */
+} t_slab_object;
+
+typedef struct s_slab {
+	void *chunks;
+	t_slab_object *free;
+	t_slab_stats stats;
+	struct s_sched_slabs *parent;
+} t_slab;
+
+typedef struct s_sched_slabs {
+	pthread_t owner;	/* Only thread using the slabs, 0 when none */
+	t_slab slabs[RINOO_SCHED_SLABS];
+} t_sched_slabs;
+
+void rinoo_slab_owner(struct s_sched *sched, pthread_t owner);
+void *rinoo_slab_alloc(struct s_sched *sched, size_t size);
+void rinoo_slab_free(void *ptr);
+int rinoo_slab_stats(struct s_sched *sched, size_t size, t_slab_stats *stats);
+void rinoo_slab_destroy(struct s_sched *sched);
+
+#endif /* !RINOO_SCHEDULER_SLAB_H_ */
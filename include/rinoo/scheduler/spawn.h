@@ -15,6 +15,7 @@
 struct s_sched;
 
 typedef struct s_thread {
+	int fd;			/* Eventfd stopping the spawn */
 	pthread_t id;
 	struct s_sched *sched;
 } t_thread;
@@ -12,15 +12,31 @@
 #define RINOO_SCHEDULER_TASK_H_
 
 #define RINOO_TASK_STACK_SIZE	(16 * 1024)
+#define RINOO_TASK_STACK_PAINT	0xa5
+#define RINOO_TASK_STACK_GUARD	64
+#define RINOO_TASK_STACK_BUCKET	1024
+#define RINOO_TASK_STACK_NBBUCKETS	(RINOO_TASK_STACK_SIZE / RINOO_TASK_STACK_BUCKET)
 
 /* Defined in scheduler.h */
 struct s_sched;
+struct s_task;
+
+typedef struct s_task_flush {
+	struct s_task *task;	/* Task owing the flush, NULL when none is pending */
+	int (*flush)(struct s_task_flush *flush);
+	t_list_node lnode;
+} t_task_flush;
 
 typedef struct s_task {
 	bool scheduled;
-	struct timeval tv;
+	bool stack_check;
+	uint64_t time;
+	uint64_t deadline;
 	struct s_sched *sched;
 	t_rbtree_node proc_node;
+	t_list flushes;
+	void (*function)(void *arg);
+	void *arg;
 	t_fcontext context;
 	char stack[RINOO_TASK_STACK_SIZE];
 
@@ -29,15 +45,23 @@ typedef struct s_task {
 #endif /* !RINOO_DEBUG */
 } t_task;
 
+typedef struct s_task_stack_stats {
+	bool enabled;
+	uint64_t nbtasks;
+	size_t max;
+	uint64_t histogram[RINOO_TASK_STACK_NBBUCKETS];
+} t_task_stack_stats;
+
 typedef struct s_task_driver {
 	t_task main;
 	t_task *current;
 	t_rbtree proc_tree;
+	t_task_stack_stats stack_stats;
 } t_task_driver;
 
 int rinoo_task_driver_init(struct s_sched *sched);
 void rinoo_task_driver_destroy(struct s_sched *sched);
-int rinoo_task_driver_run(struct s_sched *sched);
+int64_t rinoo_task_driver_run(struct s_sched *sched);
 int rinoo_task_driver_stop(struct s_sched *sched);
 uint32_t rinoo_task_driver_nbpending(struct s_sched *sched);
 t_task *rinoo_task_driver_getcurrent(struct s_sched *sched);
@@ -49,10 +73,23 @@ int rinoo_task_run(struct s_sched *sched, void (*function)(void *arg), void *arg
 int rinoo_task_resume(t_task *task);
 int rinoo_task_release(struct s_sched *sched);
 int rinoo_task_schedule(t_task *task, struct timeval *tv);
+int rinoo_task_schedule_ns(t_task *task, uint64_t time);
 int rinoo_task_unschedule(t_task *task);
 int rinoo_task_start(struct s_sched *sched, void (*function)(void *arg), void *arg);
 int rinoo_task_wait(struct s_sched *sched, uint32_t ms);
+int rinoo_task_wait_ns(struct s_sched *sched, uint64_t ns);
+int rinoo_task_wait_until(struct s_sched *sched, uint64_t time);
 int rinoo_task_pause(struct s_sched *sched);
+int rinoo_task_deadline(struct s_sched *sched, uint32_t ms);
+int rinoo_task_deadline_ns(struct s_sched *sched, uint64_t ns);
+int rinoo_task_deadline_until(struct s_sched *sched, uint64_t time);
+int rinoo_task_deadline_check(t_task *task);
 t_task *rinoo_task_self(void);
+void rinoo_task_flush_add(t_task *task, t_task_flush *flush);
+void rinoo_task_flush_remove(t_task_flush *flush);
+void rinoo_task_flush(t_task *task);
+void rinoo_task_stack_check(struct s_sched *sched, bool enabled);
+t_task_stack_stats *rinoo_task_stack_stats(struct s_sched *sched);
+void rinoo_task_stack_report(struct s_sched *sched);
 
 #endif /* RINOO_SCHEDULER_TASK_H_ */
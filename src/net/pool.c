@@ -0,0 +1,477 @@
+/**
+ * @file   pool.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 17:48:12 2026
+ *
+ * @brief  Client connection pool
+ *
+ * Connections are kept per endpoint (IP, port and SSL context) and
+ * handed back to tasks of the pool scheduler. A pool must only be used
+ * from its scheduler.
+ *
+ */
+
+#include "rinoo/net/module.h"
+
+typedef struct s_socket_pool_waiter {
+	t_task *task;
+	bool granted;
+	bool cancelled;
+	t_socket_pool_conn *conn;
+	t_list_node lnode;
+} t_socket_pool_waiter;
+
+static uint32_t rinoo_socket_pool_endpoint_hash(t_htable_node *node)
+{
+	uint32_t hash;
+	t_socket_pool_endpoint *endpoint = container_of(node, t_socket_pool_endpoint, node);
+
+	murmurhash3_x86_32(&endpoint->key, sizeof(endpoint->key), 0, &hash);
+	return hash;
+}
+
+static int rinoo_socket_pool_endpoint_cmp(t_htable_node *node1, t_htable_node *node2)
+{
+	t_socket_pool_endpoint *endpoint1 = container_of(node1, t_socket_pool_endpoint, node);
+	t_socket_pool_endpoint *endpoint2 = container_of(node2, t_socket_pool_endpoint, node);
+
+	return memcmp(&endpoint1->key, &endpoint2->key, sizeof(endpoint1->key));
+}
+
+static uint32_t rinoo_socket_pool_conn_hash(t_htable_node *node)
+{
+	t_socket_pool_conn *conn = container_of(node, t_socket_pool_conn, hnode);
+
+	return (uint32_t) ((uintptr_t) conn->socket >> 4);
+}
+
+static int rinoo_socket_pool_conn_cmp(t_htable_node *node1, t_htable_node *node2)
+{
+	t_socket_pool_conn *conn1 = container_of(node1, t_socket_pool_conn, hnode);
+	t_socket_pool_conn *conn2 = container_of(node2, t_socket_pool_conn, hnode);
+
+	if (conn1->socket == conn2->socket) {
+		return 0;
+	}
+	return ((uintptr_t) conn1->socket > (uintptr_t) conn2->socket ? 1 : -1);
+}
+
+/**
+ * Creates a connection pool for a scheduler.
+ *
+ * @param sched Scheduler using the pool
+ * @param config Pool configuration
+ *
+ * @return Pointer to the new pool or NULL if an error occurs
+ */
+t_socket_pool *rinoo_socket_pool(t_sched *sched, const t_socket_pool_config *config)
+{
+	t_socket_pool *pool;
+
+	XASSERT(sched != NULL, NULL);
+	XASSERT(config != NULL, NULL);
+
+	pool = calloc(1, sizeof(*pool));
+	if (unlikely(pool == NULL)) {
+		return NULL;
+	}
+	pool->sched = sched;
+	pool->config = *config;
+	if (pool->config.check == NULL) {
+		pool->config.check = rinoo_socket_pool_check;
+	}
+	if (htable(&pool->endpoints, RINOO_POOL_HTABLE_SIZE, rinoo_socket_pool_endpoint_hash, rinoo_socket_pool_endpoint_cmp) != 0) {
+		free(pool);
+		return NULL;
+	}
+	if (htable(&pool->conns, RINOO_POOL_HTABLE_SIZE, rinoo_socket_pool_conn_hash, rinoo_socket_pool_conn_cmp) != 0) {
+		htable_destroy(&pool->endpoints);
+		free(pool);
+		return NULL;
+	}
+	return pool;
+}
+
+static void rinoo_socket_pool_conn_free(t_list_node *node)
+{
+	t_socket_pool_conn *conn = container_of(node, t_socket_pool_conn, lnode);
+
+	rinoo_socket_destroy(conn->socket);
+	free(conn);
+}
+
+static void rinoo_socket_pool_endpoint_free(t_htable_node *node)
+{
+	t_socket_pool_waiter *waiter;
+	t_socket_pool_endpoint *endpoint = container_of(node, t_socket_pool_endpoint, node);
+
+	/* Waiting tasks are woken up with ECANCELED */
+	while (endpoint->waiters.tail != NULL) {
+		waiter = container_of(endpoint->waiters.tail, t_socket_pool_waiter, lnode);
+		list_remove(&endpoint->waiters, &waiter->lnode);
+		waiter->granted = false;
+		waiter->cancelled = true;
+		rinoo_task_schedule(waiter->task, NULL);
+	}
+	list_flush(&endpoint->idle, rinoo_socket_pool_conn_free);
+	free(endpoint);
+}
+
+static void rinoo_socket_pool_acquired_free(t_htable_node *node)
+{
+	free(container_of(node, t_socket_pool_conn, hnode));
+}
+
+/**
+ * Destroys a connection pool and closes its idle connections.
+ * Acquired sockets are left to their owners which have to destroy them.
+ * Tasks waiting for a connection fail with ECANCELED.
+ *
+ * @param pool Pool to destroy
+ */
+void rinoo_socket_pool_destroy(t_socket_pool *pool)
+{
+	XASSERTN(pool != NULL);
+
+	htable_flush(&pool->conns, rinoo_socket_pool_acquired_free);
+	htable_destroy(&pool->conns);
+	htable_flush(&pool->endpoints, rinoo_socket_pool_endpoint_free);
+	htable_destroy(&pool->endpoints);
+	free(pool);
+}
+
+/**
+ * Default health check of idle connections. A connection is unhealthy
+ * when the peer closed it, or when unexpected data is pending, either
+ * in the read-ahead buffer or on the socket. SSL sockets process
+ * pending records, see rinoo_ssl_check.
+ *
+ * @param socket Socket to check
+ *
+ * @return 0 if the connection can be reused, otherwise -1
+ */
+int rinoo_socket_pool_check(t_socket *socket)
+{
+	char c;
+	ssize_t ret;
+
+	if (socket->readahead.end > socket->readahead.start) {
+		return -1;
+	}
+	if (socket->class->read == rinoo_socket_class_ssl_read) {
+		return rinoo_ssl_check(socket);
+	}
+	ret = recv(socket->node.fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+	if (ret < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1);
+	}
+	return -1;
+}
+
+/**
+ * Gets the pool endpoint of an IP, port and SSL context, creates it if needed.
+ *
+ * @param pool Pool to use
+ * @param ip Destination IP, NULL for loopback
+ * @param port Destination port
+ * @param ctx SSL context, NULL for plain TCP
+ *
+ * @return Pointer to the endpoint or NULL if an error occurs
+ */
+static t_socket_pool_endpoint *rinoo_socket_pool_endpoint(t_socket_pool *pool, t_ip *ip, uint16_t port, t_ssl_ctx *ctx)
+{
+	t_htable_node *node;
+	t_socket_pool_endpoint key;
+	t_socket_pool_endpoint *endpoint;
+
+	memset(&key, 0, sizeof(key));
+	if (ip == NULL) {
+		key.key.ip.v4.sin_family = AF_INET;
+		key.key.ip.v4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	} else if (IS_IPV6(ip)) {
+		key.key.ip.v6 = ip->v6;
+	} else {
+		key.key.ip.v4.sin_family = AF_INET;
+		key.key.ip.v4.sin_addr = ip->v4.sin_addr;
+	}
+	if (IS_IPV6((&key.key.ip))) {
+		key.key.ip.v6.sin6_port = htons(port);
+	} else {
+		key.key.ip.v4.sin_port = htons(port);
+	}
+	key.key.ctx = ctx;
+	node = htable_get(&pool->endpoints, &key.node);
+	if (node != NULL) {
+		return container_of(node, t_socket_pool_endpoint, node);
+	}
+	endpoint = calloc(1, sizeof(*endpoint));
+	if (unlikely(endpoint == NULL)) {
+		return NULL;
+	}
+	endpoint->key = key.key;
+	list(&endpoint->idle, NULL);
+	list(&endpoint->waiters, NULL);
+	htable_put(&pool->endpoints, &endpoint->node);
+	return endpoint;
+}
+
+/**
+ * Closes idle connections of an endpoint which exceeded the idle timeout.
+ * Idle lists are ordered from the most recently released connection.
+ *
+ * @param pool Pool to use
+ * @param endpoint Endpoint to check
+ */
+static void rinoo_socket_pool_expire(t_socket_pool *pool, t_socket_pool_endpoint *endpoint)
+{
+	uint64_t limit;
+	t_socket_pool_conn *conn;
+
+	if (pool->config.idle_timeout == 0 || pool->sched->clock < pool->config.idle_timeout * RINOO_NSEC_PER_MSEC) {
+		return;
+	}
+	limit = pool->sched->clock - pool->config.idle_timeout * RINOO_NSEC_PER_MSEC;
+	while (endpoint->idle.tail != NULL) {
+		conn = container_of(endpoint->idle.tail, t_socket_pool_conn, lnode);
+		if (conn->idle_since > limit) {
+			break;
+		}
+		list_remove(&endpoint->idle, &conn->lnode);
+		rinoo_socket_pool_conn_free(&conn->lnode);
+		endpoint->nbconns--;
+		pool->stats.expired++;
+	}
+}
+
+/**
+ * Hands a connection slot over to the oldest waiting task, if any.
+ *
+ * @param endpoint Endpoint to use
+ * @param conn Connection to give, or NULL to only give the slot
+ *
+ * @return true if a waiting task took the slot, otherwise false
+ */
+static bool rinoo_socket_pool_handoff(t_socket_pool_endpoint *endpoint, t_socket_pool_conn *conn)
+{
+	t_socket_pool_waiter *waiter;
+
+	if (endpoint->waiters.tail == NULL) {
+		return false;
+	}
+	waiter = container_of(endpoint->waiters.tail, t_socket_pool_waiter, lnode);
+	list_remove(&endpoint->waiters, &waiter->lnode);
+	waiter->granted = true;
+	waiter->conn = conn;
+	rinoo_task_schedule(waiter->task, NULL);
+	return true;
+}
+
+/**
+ * Waits for a connection slot of an endpoint to be released.
+ *
+ * @param pool Pool to use
+ * @param endpoint Endpoint to wait for
+ * @param conn Pointer where to store a released connection, NULL if only a slot was released
+ *
+ * @return 0 on success or -1 if an error occurs (ETIMEDOUT when the pool timeout or the task deadline is reached, ECANCELED when the pool is destroyed)
+ */
+static int rinoo_socket_pool_wait(t_socket_pool *pool, t_socket_pool_endpoint *endpoint, t_socket_pool_conn **conn)
+{
+	int ret;
+	uint64_t time;
+	t_socket_pool_waiter waiter;
+
+	waiter.task = rinoo_task_self();
+	waiter.granted = false;
+	waiter.cancelled = false;
+	waiter.conn = NULL;
+	/* Flushing may park this task: done before other tasks can wake it up */
+	rinoo_task_flush(waiter.task);
+	if (rinoo_task_deadline_check(waiter.task) != 0) {
+		return -1;
+	}
+	if (pool->config.timeout != 0) {
+		time = pool->sched->clock + pool->config.timeout * RINOO_NSEC_PER_MSEC;
+		if (waiter.task->deadline != 0 && waiter.task->deadline < time) {
+			/* Never go beyond the task deadline */
+			time = waiter.task->deadline;
+		}
+		if (rinoo_task_schedule_ns(waiter.task, time) != 0) {
+			return -1;
+		}
+	}
+	list_put(&endpoint->waiters, &waiter.lnode);
+	pool->stats.waited++;
+	ret = rinoo_task_release(pool->sched);
+	if (waiter.cancelled) {
+		/* The pool is gone, so is the endpoint */
+		errno = ECANCELED;
+		return -1;
+	}
+	if (!waiter.granted) {
+		list_remove(&endpoint->waiters, &waiter.lnode);
+		errno = (ret != 0 ? ECANCELED : ETIMEDOUT);
+		return -1;
+	}
+	*conn = waiter.conn;
+	return 0;
+}
+
+/**
+ * Acquires a connection to an endpoint. An idle connection is reused when
+ * it passes the health check, otherwise a new TCP connection (or SSL if ctx
+ * is set) is created. When the endpoint reached its connection limit, the
+ * calling task waits for a connection to be released.
+ *
+ * @param pool Pool to use
+ * @param ip Destination IP, NULL for loopback
+ * @param port Destination port
+ * @param ctx SSL context, NULL for plain TCP
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_socket_pool_acquire(t_socket_pool *pool, t_ip *ip, uint16_t port, t_ssl_ctx *ctx)
+{
+	t_ip addr;
+	t_list_node *node;
+	t_socket_pool_conn *conn;
+	t_socket_pool_endpoint *endpoint;
+
+	XASSERT(pool != NULL, NULL);
+
+	endpoint = rinoo_socket_pool_endpoint(pool, ip, port, ctx);
+	if (unlikely(endpoint == NULL)) {
+		return NULL;
+	}
+	rinoo_socket_pool_expire(pool, endpoint);
+	while ((node = list_pop(&endpoint->idle)) != NULL) {
+		conn = container_of(node, t_socket_pool_conn, lnode);
+		if (pool->config.check(conn->socket) == 0) {
+			pool->stats.reused++;
+			goto acquire_done;
+		}
+		rinoo_socket_pool_conn_free(node);
+		endpoint->nbconns--;
+		pool->stats.unhealthy++;
+	}
+	if (pool->config.max_per_endpoint != 0 && endpoint->nbconns >= pool->config.max_per_endpoint) {
+		if (rinoo_socket_pool_wait(pool, endpoint, &conn) != 0) {
+			return NULL;
+		}
+		if (conn != NULL) {
+			pool->stats.reused++;
+			goto acquire_done;
+		}
+	} else {
+		endpoint->nbconns++;
+	}
+	/* The slot is reserved, connecting releases the task */
+	conn = calloc(1, sizeof(*conn));
+	if (unlikely(conn == NULL)) {
+		goto acquire_error;
+	}
+	conn->endpoint = endpoint;
+	addr = endpoint->key.ip;
+	if (ctx != NULL) {
+		conn->socket = rinoo_ssl_client(pool->sched, ctx, &addr, port, pool->config.timeout);
+	} else {
+		conn->socket = rinoo_tcp_client(pool->sched, &addr, port, pool->config.timeout);
+	}
+	if (conn->socket == NULL) {
+		free(conn);
+		goto acquire_error;
+	}
+	pool->stats.created++;
+acquire_done:
+	htable_put(&pool->conns, &conn->hnode);
+	return conn->socket;
+acquire_error:
+	if (!rinoo_socket_pool_handoff(endpoint, NULL)) {
+		endpoint->nbconns--;
+	}
+	return NULL;
+}
+
+/**
+ * Removes an acquired socket from the pool.
+ *
+ * @param pool Pool to use
+ * @param socket Acquired socket
+ *
+ * @return Pointer to the pool connection or NULL if socket was not acquired from pool
+ */
+static t_socket_pool_conn *rinoo_socket_pool_detach(t_socket_pool *pool, t_socket *socket)
+{
+	t_htable_node *node;
+	t_socket_pool_conn key;
+
+	key.socket = socket;
+	node = htable_get(&pool->conns, &key.hnode);
+	if (node == NULL) {
+		return NULL;
+	}
+	htable_remove(&pool->conns, node);
+	return container_of(node, t_socket_pool_conn, hnode);
+}
+
+/**
+ * Gives an acquired socket back to the pool to be reused.
+ * The socket must be in a clean protocol state, otherwise it
+ * should be discarded with rinoo_socket_pool_discard.
+ *
+ * @param pool Pool to use
+ * @param socket Socket to release
+ */
+void rinoo_socket_pool_release(t_socket_pool *pool, t_socket *socket)
+{
+	t_socket_pool_conn *conn;
+	t_socket_pool_endpoint *endpoint;
+
+	XASSERTN(pool != NULL);
+	XASSERTN(socket != NULL);
+
+	conn = rinoo_socket_pool_detach(pool, socket);
+	if (conn == NULL) {
+		rinoo_socket_destroy(socket);
+		return;
+	}
+	endpoint = conn->endpoint;
+	if (rinoo_socket_pool_handoff(endpoint, conn)) {
+		return;
+	}
+	rinoo_socket_pool_expire(pool, endpoint);
+	if (endpoint->idle.size >= pool->config.max_idle) {
+		rinoo_socket_pool_conn_free(&conn->lnode);
+		endpoint->nbconns--;
+		return;
+	}
+	conn->idle_since = pool->sched->clock;
+	list_put(&endpoint->idle, &conn->lnode);
+}
+
+/**
+ * Closes an acquired socket which cannot be reused (after an error
+ * or in the middle of an exchange) and frees its pool slot.
+ *
+ * @param pool Pool to use
+ * @param socket Socket to discard
+ */
+void rinoo_socket_pool_discard(t_socket_pool *pool, t_socket *socket)
+{
+	t_socket_pool_conn *conn;
+	t_socket_pool_endpoint *endpoint;
+
+	XASSERTN(pool != NULL);
+	XASSERTN(socket != NULL);
+
+	conn = rinoo_socket_pool_detach(pool, socket);
+	if (conn == NULL) {
+		rinoo_socket_destroy(socket);
+		return;
+	}
+	endpoint = conn->endpoint;
+	rinoo_socket_pool_conn_free(&conn->lnode);
+	if (!rinoo_socket_pool_handoff(endpoint, NULL)) {
+		endpoint->nbconns--;
+	}
+}
@@ -79,21 +79,56 @@ t_socket *rinoo_socket_dup(t_sched *destination, t_socket *socket)
 		return NULL;
 	}
 	new->node.sched = destination;
+	/* Buffered data stays with the original socket */
+	memset(&new->readahead, 0, sizeof(new->readahead));
+	memset(&new->coalesce, 0, sizeof(new->coalesce));
+	new->defaults = NULL;
+	if (socket->defaults != NULL) {
+		new->defaults = malloc(sizeof(*new->defaults));
+		if (unlikely(new->defaults == NULL)) {
+			rinoo_socket_destroy(new);
+			return NULL;
+		}
+		*new->defaults = *socket->defaults;
+	}
 	return new;
 }
 
 /**
  * Close a socket only (does not free memory).
+ * Coalesced data is flushed first, unless no write can block: outside of
+ * the socket scheduler, or from its main task once it is stopped. Data
+ * which could not be sent is then logged and counted in sched->dropped.
  *
  * @param socket Pointer to the socket to close
  */
 void rinoo_socket_close(t_socket *socket)
 {
+	size_t len;
+	t_task *task;
+
 	XASSERTN(socket != NULL);
 
+	if (socket->coalesce.len > 0 && !socket->coalesce.flushing) {
+		len = socket->coalesce.len;
+		task = rinoo_task_self();
+		if (task == NULL || task->sched != socket->node.sched ||
+		    (task == &socket->node.sched->driver.main && socket->node.sched->stop) ||
+		    rinoo_socket_flush(socket) != 0) {
+			socket->node.sched->dropped += len;
+			rinoo_log("socket %d - %zu coalesced bytes dropped on close", socket->node.fd, len);
+		}
+	}
+	rinoo_task_flush_remove(&socket->coalesce.flush);
 	rinoo_sched_remove(&socket->node);
 	socket->class->close(socket);
 	memset(&socket->node, 0, sizeof(socket->node));
+	free(socket->readahead.buf);
+	memset(&socket->readahead, 0, sizeof(socket->readahead));
+	free(socket->coalesce.buf);
+	memset(&socket->coalesce, 0, sizeof(socket->coalesce));
+	free(socket->defaults);
+	socket->defaults = NULL;
 }
 
 /**
@@ -165,18 +200,333 @@ int rinoo_socket_waitio(t_socket *socket)
  */
 int rinoo_socket_timeout(t_socket *socket, uint32_t ms)
 {
-	struct timeval res;
-	struct timeval toadd;
+	return rinoo_socket_timeout_ns(socket, ms * RINOO_NSEC_PER_MSEC);
+}
+
+/**
+ * Schedules a socket to be waken up.
+ *
+ * @param socket Socket pointer
+ * @param ns Timeout in nanoseconds
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_timeout_ns(t_socket *socket, uint64_t ns)
+{
+	t_task *task;
+	uint64_t time;
+
+	XASSERT(socket != NULL, -1);
+
+	task = rinoo_task_driver_getcurrent(socket->node.sched);
+	if (ns == 0) {
+		return rinoo_task_schedule_ns(task, 0);
+	}
+	time = socket->node.sched->clock + ns;
+	if (task->deadline != 0 && task->deadline < time) {
+		/* Never go beyond the task deadline */
+		time = task->deadline;
+	}
+	return rinoo_task_schedule_ns(task, time);
+}
+
+/**
+ * Enables MSG_ZEROCOPY for writes of at least threshold bytes.
+ * Only TCP sockets support it. Zerocopy writes only return once the
+ * kernel released the written buffer, so the buffer can be reused as
+ * with regular writes. Zerocopy gets disabled again as soon as the kernel
+ * reports it had to copy the data (like on loopback), as it is then
+ * slower than a regular write.
+ *
+ * @param socket Pointer to the socket to use
+ * @param threshold Minimum write size to use zerocopy, 0 to disable it
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_zerocopy(t_socket *socket, size_t threshold)
+{
+	int enabled;
+
+	XASSERT(socket != NULL, -1);
+
+	if (socket->class->write != rinoo_socket_class_tcp_write) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+	if (threshold == 0) {
+		socket->zerocopy.threshold = 0;
+		return 0;
+	}
+#ifdef SO_ZEROCOPY
+	enabled = 1;
+	if (setsockopt(socket->node.fd, SOL_SOCKET, SO_ZEROCOPY, &enabled, sizeof(enabled)) != 0) {
+		return -1;
+	}
+	socket->node.errqueue = true;
+	socket->zerocopy.threshold = threshold;
+	return 0;
+#else
+	(void) enabled;
+	errno = EOPNOTSUPP;
+	return -1;
+#endif /* !SO_ZEROCOPY */
+}
+
+/**
+ * Gets the setsockopt(2) level and name of a socket option.
+ *
+ * @param socket Pointer to the socket to use
+ * @param option Socket option
+ * @param level Pointer where to store the option level
+ * @param name Pointer where to store the option name
+ *
+ * @return 0 on success or -1 if the option is not supported
+ */
+static int rinoo_socket_option(t_socket *socket, t_socket_option option, int *level, int *name)
+{
+	int domain;
+	socklen_t len;
+
+	switch (option) {
+	case RINOO_SOCKET_NODELAY:
+		*level = IPPROTO_TCP;
+		*name = TCP_NODELAY;
+		return 0;
+	case RINOO_SOCKET_SNDBUF:
+		*level = SOL_SOCKET;
+		*name = SO_SNDBUF;
+		return 0;
+	case RINOO_SOCKET_RCVBUF:
+		*level = SOL_SOCKET;
+		*name = SO_RCVBUF;
+		return 0;
+	case RINOO_SOCKET_QUICKACK:
+		*level = IPPROTO_TCP;
+		*name = TCP_QUICKACK;
+		return 0;
+	case RINOO_SOCKET_NOTSENT_LOWAT:
+		*level = IPPROTO_TCP;
+		*name = TCP_NOTSENT_LOWAT;
+		return 0;
+	case RINOO_SOCKET_BUSY_POLL:
+#ifdef SO_BUSY_POLL
+		*level = SOL_SOCKET;
+		*name = SO_BUSY_POLL;
+		return 0;
+#else
+		break;
+#endif /* !SO_BUSY_POLL */
+	case RINOO_SOCKET_TOS:
+		len = sizeof(domain);
+		if (getsockopt(socket->node.fd, SOL_SOCKET, SO_DOMAIN, &domain, &len) != 0) {
+			return -1;
+		}
+		if (domain == AF_INET6) {
+			*level = IPPROTO_IPV6;
+			*name = IPV6_TCLASS;
+		} else {
+			*level = IPPROTO_IP;
+			*name = IP_TOS;
+		}
+		return 0;
+	case RINOO_SOCKET_KEEPALIVE:
+		*level = SOL_SOCKET;
+		*name = SO_KEEPALIVE;
+		return 0;
+	case RINOO_SOCKET_KEEPIDLE:
+		*level = IPPROTO_TCP;
+		*name = TCP_KEEPIDLE;
+		return 0;
+	case RINOO_SOCKET_KEEPINTVL:
+		*level = IPPROTO_TCP;
+		*name = TCP_KEEPINTVL;
+		return 0;
+	case RINOO_SOCKET_KEEPCNT:
+		*level = IPPROTO_TCP;
+		*name = TCP_KEEPCNT;
+		return 0;
+	default:
+		break;
+	}
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+/**
+ * Sets a socket option.
+ * This works the same for every socket class, SSL sockets included.
+ *
+ * @param socket Pointer to the socket to use
+ * @param option Socket option to set
+ * @param value Option value, see t_socket_option for units
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_set_option(t_socket *socket, t_socket_option option, int value)
+{
+	int name;
+	int level;
+
+	XASSERT(socket != NULL, -1);
+
+	if (rinoo_socket_option(socket, option, &level, &name) != 0) {
+		return -1;
+	}
+	return setsockopt(socket->node.fd, level, name, &value, sizeof(value));
+}
+
+/**
+ * Gets a socket option value.
+ * Note that the kernel doubles SO_SNDBUF and SO_RCVBUF values for its
+ * own bookkeeping.
+ *
+ * @param socket Pointer to the socket to use
+ * @param option Socket option to get
+ * @param value Pointer where to store the option value
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_get_option(t_socket *socket, t_socket_option option, int *value)
+{
+	int name;
+	int level;
+	socklen_t len;
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(value != NULL, -1);
+
+	if (rinoo_socket_option(socket, option, &level, &name) != 0) {
+		return -1;
+	}
+	len = sizeof(*value);
+	return getsockopt(socket->node.fd, level, name, value, &len);
+}
+
+/**
+ * Sets an option default value on a listening socket.
+ * Sockets accepted afterwards get this option set, whatever their class.
+ *
+ * @param socket Pointer to the listening socket
+ * @param option Socket option to set on accepted sockets
+ * @param value Option value
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_set_default(t_socket *socket, t_socket_option option, int value)
+{
+	XASSERT(socket != NULL, -1);
+	XASSERT(option < RINOO_SOCKET_OPTION_MAX, -1);
+
+	if (socket->defaults == NULL) {
+		socket->defaults = calloc(1, sizeof(*socket->defaults));
+		if (unlikely(socket->defaults == NULL)) {
+			return -1;
+		}
+	}
+	socket->defaults->set |= (1 << option);
+	socket->defaults->values[option] = value;
+	return 0;
+}
+
+/**
+ * Applies listener default options to an accepted socket.
+ * This is called by socket classes when accepting connections.
+ *
+ * @param socket Pointer to the accepted socket
+ * @param listener Pointer to the listening socket
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_inherit(t_socket *socket, t_socket *listener)
+{
+	int i;
+
+	if (likely(listener->defaults == NULL)) {
+		return 0;
+	}
+	for (i = 0; i < RINOO_SOCKET_OPTION_MAX; i++) {
+		if ((listener->defaults->set & (1 << i)) != 0 &&
+		    rinoo_socket_set_option(socket, i, listener->defaults->values[i]) != 0) {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Reads zerocopy completions from the socket error queue.
+ *
+ * @param socket Pointer to the socket to use
+ *
+ * @return 1 if completions have been read, 0 if there was none or -1 if an error occurs
+ */
+static int rinoo_socket_zerocopy_reap(t_socket *socket)
+{
+	int ret;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	struct sock_extended_err *err;
+	char control[CMSG_SPACE(sizeof(*err)) * 2];
+
+	ret = 0;
+	while (1) {
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		if (recvmsg(socket->node.fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return ret;
+			}
+			return -1;
+		}
+		for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if ((cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) &&
+			    (cmsg->cmsg_level != SOL_IPV6 || cmsg->cmsg_type != IPV6_RECVERR)) {
+				continue;
+			}
+			err = (struct sock_extended_err *) CMSG_DATA(cmsg);
+			if (err->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+				errno = (err->ee_errno != 0 ? err->ee_errno : EIO);
+				return -1;
+			}
+			/* ee_info to ee_data is the range of released sends */
+			if ((int32_t) (err->ee_data + 1 - socket->zerocopy.completed) > 0) {
+				socket->zerocopy.completed = err->ee_data + 1;
+			}
+			if ((err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) == SO_EE_CODE_ZEROCOPY_COPIED) {
+				socket->zerocopy.copied++;
+				socket->zerocopy.threshold = 0;
+			}
+			ret = 1;
+		}
+	}
+}
 
+/**
+ * Waits for the kernel to release every buffer sent with MSG_ZEROCOPY.
+ * Completions are received through the socket error queue, the task
+ * is released until then.
+ *
+ * @param socket Pointer to the socket to use
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_zerocopy_wait(t_socket *socket)
+{
 	XASSERT(socket != NULL, -1);
 
-	if (ms == 0) {
-		return rinoo_task_schedule(rinoo_task_driver_getcurrent(socket->node.sched), NULL);
+	while ((int32_t) (socket->zerocopy.sent - socket->zerocopy.completed) > 0) {
+		if (rinoo_socket_zerocopy_reap(socket) < 0) {
+			return -1;
+		}
+		if ((int32_t) (socket->zerocopy.sent - socket->zerocopy.completed) <= 0) {
+			break;
+		}
+		if (rinoo_sched_waitfor(&socket->node, RINOO_MODE_ERR) != 0) {
+			return -1;
+		}
 	}
-	toadd.tv_sec = ms / 1000;
-	toadd.tv_usec = (ms % 1000) * 1000;
-	timeradd(&socket->node.sched->clock, &toadd, &res);
-	return rinoo_task_schedule(rinoo_task_driver_getcurrent(socket->node.sched), &res);
+	return 0;
 }
 
 /**
@@ -233,6 +583,7 @@ t_socket *rinoo_socket_accept(t_socket *socket, struct sockaddr *addr, socklen_t
 
 /**
  * Calls the appropriate read function depending on socket class.
+ * Buffered data is returned first when read-ahead is enabled.
  *
  * @param socket Pointer to the socket to read
  * @param buf Buffer where to store the information read
@@ -242,7 +593,262 @@ t_socket *rinoo_socket_accept(t_socket *socket, struct sockaddr *addr, socklen_t
  */
 ssize_t rinoo_socket_read(t_socket *socket, void *buf, size_t count)
 {
-	return socket->class->read(socket, buf, count);
+	ssize_t res;
+	t_socket_readahead *readahead;
+
+	readahead = &socket->readahead;
+	if (likely(readahead->size == 0)) {
+		return socket->class->read(socket, buf, count);
+	}
+	if (readahead->start == readahead->end) {
+		if (count >= readahead->size) {
+			/* Large reads go straight to the caller buffer */
+			return socket->class->read(socket, buf, count);
+		}
+		res = socket->class->read(socket, readahead->buf, readahead->size);
+		if (res <= 0) {
+			return res;
+		}
+		readahead->start = 0;
+		readahead->end = res;
+	}
+	if (count > readahead->end - readahead->start) {
+		count = readahead->end - readahead->start;
+	}
+	memcpy(buf, readahead->buf + readahead->start, count);
+	readahead->start += count;
+	return count;
+}
+
+/**
+ * Enables a read-ahead buffer on a stream socket. Reads smaller than
+ * size are then served from memory, the buffer being filled with one
+ * read of up to size bytes. This is also needed by rinoo_socket_peek.
+ *
+ * @param socket Pointer to the socket to use
+ * @param size Read-ahead buffer size, 0 to disable it
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_readahead(t_socket *socket, size_t size)
+{
+	char *buf;
+	t_socket_readahead *readahead;
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->type == SOCK_STREAM, -1);
+
+	readahead = &socket->readahead;
+	if (size < readahead->end - readahead->start) {
+		/* Buffered data would be lost */
+		errno = EBUSY;
+		return -1;
+	}
+	if (size == 0) {
+		free(readahead->buf);
+		memset(readahead, 0, sizeof(*readahead));
+		return 0;
+	}
+	if (readahead->start > 0) {
+		memmove(readahead->buf, readahead->buf + readahead->start, readahead->end - readahead->start);
+		readahead->end -= readahead->start;
+		readahead->start = 0;
+	}
+	buf = realloc(readahead->buf, size);
+	if (unlikely(buf == NULL)) {
+		return -1;
+	}
+	readahead->buf = buf;
+	readahead->size = size;
+	return 0;
+}
+
+/**
+ * Gets the next count bytes of a socket without consuming them.
+ * Reads until count bytes are buffered, count cannot exceed the
+ * read-ahead buffer size.
+ *
+ * @param socket Pointer to the socket to use
+ * @param count Number of bytes to peek
+ *
+ * @return Pointer to the buffered bytes, valid until next read, or NULL if an error occurs
+ */
+void *rinoo_socket_peek(t_socket *socket, size_t count)
+{
+	ssize_t res;
+	t_socket_readahead *readahead;
+
+	XASSERT(socket != NULL, NULL);
+
+	readahead = &socket->readahead;
+	if (count > readahead->size) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if (readahead->size - readahead->start < count) {
+		memmove(readahead->buf, readahead->buf + readahead->start, readahead->end - readahead->start);
+		readahead->end -= readahead->start;
+		readahead->start = 0;
+	}
+	while (readahead->end - readahead->start < count) {
+		res = socket->class->read(socket, readahead->buf + readahead->end, readahead->size - readahead->end);
+		if (res <= 0) {
+			return NULL;
+		}
+		readahead->end += res;
+	}
+	return readahead->buf + readahead->start;
+}
+
+/**
+ * Drops bytes from the read-ahead buffer, typically after rinoo_socket_peek.
+ *
+ * @param socket Pointer to the socket to use
+ * @param count Number of bytes to drop
+ *
+ * @return 0 on success or -1 if less than count bytes are buffered
+ */
+int rinoo_socket_consume(t_socket *socket, size_t count)
+{
+	XASSERT(socket != NULL, -1);
+
+	if (count > socket->readahead.end - socket->readahead.start) {
+		errno = EINVAL;
+		return -1;
+	}
+	socket->readahead.start += count;
+	return 0;
+}
+
+/**
+ * Reads exactly count bytes from a socket.
+ *
+ * @param socket Pointer to the socket to read
+ * @param buf Buffer where to store the information read
+ * @param count Number of bytes to read
+ *
+ * @return count on success or -1 if an error occurs (including end of stream before count bytes)
+ */
+ssize_t rinoo_socket_read_exact(t_socket *socket, void *buf, size_t count)
+{
+	size_t total;
+	ssize_t res;
+
+	XASSERT(socket != NULL, -1);
+
+	for (total = 0; total < count; total += res) {
+		res = rinoo_socket_read(socket, buf + total, count - total);
+		if (res <= 0) {
+			return -1;
+		}
+	}
+	return count;
+}
+
+/**
+ * Sends coalesced data followed by more buffers, then empties the coalescing buffer.
+ *
+ * @param socket Pointer to the socket to use
+ * @param buffers Buffers to send, the first one being the coalesced data
+ * @param count Number of buffers
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_coalesce_writev(t_socket *socket, t_buffer **buffers, int count)
+{
+	ssize_t ret;
+	t_socket_coalesce *coalesce;
+
+	coalesce = &socket->coalesce;
+	rinoo_task_flush_remove(&coalesce->flush);
+	/* Writes made while this one is blocked must not touch the buffer */
+	coalesce->flushing = true;
+	ret = socket->class->writev(socket, buffers, count);
+	coalesce->flushing = false;
+	coalesce->len = 0;
+	coalesce->flushes++;
+	if (ret < 0) {
+		if (socket->node.error == 0) {
+			/* Report the failure on the next operation */
+			socket->node.error = (errno != 0 ? errno : EPIPE);
+		}
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Task flush callback of coalescing sockets.
+ *
+ * @param flush Pointer to the socket flush
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_coalesce_flush(t_task_flush *flush)
+{
+	return rinoo_socket_flush(container_of(flush, t_socket, coalesce.flush));
+}
+
+/**
+ * Enables write coalescing on a stream socket. Writes fitting in the
+ * coalescing buffer are stored and sent with one syscall when the
+ * writing task releases execution (I/O wait, timer, channel or end of
+ * task), when the buffer is full, on rinoo_socket_flush, or before any
+ * write which cannot be stored.
+ *
+ * @param socket Pointer to the socket to use
+ * @param size Coalescing buffer size, 0 to disable it
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_coalesce(t_socket *socket, size_t size)
+{
+	char *buf;
+	t_socket_coalesce *coalesce;
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->type == SOCK_STREAM, -1);
+	XASSERT(socket->class->writev != NULL, -1);
+
+	coalesce = &socket->coalesce;
+	if (coalesce->len > 0 && rinoo_socket_flush(socket) != 0) {
+		return -1;
+	}
+	if (size == 0) {
+		free(coalesce->buf);
+		memset(coalesce, 0, sizeof(*coalesce));
+		return 0;
+	}
+	buf = realloc(coalesce->buf, size);
+	if (unlikely(buf == NULL)) {
+		return -1;
+	}
+	coalesce->buf = buf;
+	coalesce->size = size;
+	coalesce->flush.flush = rinoo_socket_coalesce_flush;
+	return 0;
+}
+
+/**
+ * Sends data stored by write coalescing.
+ *
+ * @param socket Pointer to the socket to flush
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_flush(t_socket *socket)
+{
+	t_buffer pending;
+	t_buffer *buffers[1];
+
+	XASSERT(socket != NULL, -1);
+
+	if (socket->coalesce.len == 0 || socket->coalesce.flushing) {
+		return 0;
+	}
+	buffer_static(&pending, socket->coalesce.buf, socket->coalesce.len);
+	buffers[0] = &pending;
+	return rinoo_socket_coalesce_writev(socket, buffers, 1);
 }
 
 /**
@@ -274,7 +880,36 @@ ssize_t rinoo_socket_recvfrom(t_socket *socket, void *buf, size_t count, struct
  */
 ssize_t	rinoo_socket_write(t_socket *socket, const void *buf, size_t count)
 {
-	return socket->class->write(socket, buf, count);
+	t_task *task;
+	t_buffer pending;
+	t_buffer data;
+	t_buffer *buffers[2];
+	t_socket_coalesce *coalesce;
+
+	coalesce = &socket->coalesce;
+	if (likely(coalesce->size == 0) || coalesce->flushing) {
+		return socket->class->write(socket, buf, count);
+	}
+	task = rinoo_task_self();
+	if (count <= coalesce->size - coalesce->len && task != NULL && task != &socket->node.sched->driver.main) {
+		memcpy(coalesce->buf + coalesce->len, buf, count);
+		coalesce->len += count;
+		coalesce->writes++;
+		rinoo_task_flush_add(task, &coalesce->flush);
+		return count;
+	}
+	if (coalesce->len == 0) {
+		return socket->class->write(socket, buf, count);
+	}
+	/* Pending data and this write go out with one syscall */
+	buffer_static(&pending, coalesce->buf, coalesce->len);
+	buffer_static(&data, (void *) buf, count);
+	buffers[0] = &pending;
+	buffers[1] = &data;
+	if (rinoo_socket_coalesce_writev(socket, buffers, 2) != 0) {
+		return -1;
+	}
+	return count;
 }
 
 /**
@@ -292,6 +927,9 @@ ssize_t	rinoo_socket_writev(t_socket *socket, t_buffer **buffers, int count)
 	ssize_t ret;
 	ssize_t total;
 
+	if (socket->coalesce.len > 0 && rinoo_socket_flush(socket) != 0) {
+		return -1;
+	}
 	if (socket->class->writev != NULL) {
 		return socket->class->writev(socket, buffers, count);
 	} else {
@@ -325,6 +963,40 @@ ssize_t rinoo_socket_sendto(t_socket *socket, void *buf, size_t count, const str
 	return socket->class->sendto(socket, buf, count, addrto, addrlen);
 }
 
+/**
+ * Receives a batch of datagrams if possible by socket class.
+ *
+ * @param socket Pointer to the socket to read
+ * @param msgs Array of messages to fill
+ * @param count Array size
+ *
+ * @return The number of datagrams received on success or -1 if an error occurs
+ */
+int rinoo_socket_recvmmsg(t_socket *socket, t_socket_msg *msgs, int count)
+{
+	XASSERT(socket->class->recvmmsg != NULL, -1);
+	XASSERT(count > 0, -1);
+
+	return socket->class->recvmmsg(socket, msgs, count);
+}
+
+/**
+ * Sends a batch of datagrams if possible by socket class.
+ *
+ * @param socket Pointer to the socket to write
+ * @param msgs Array of messages to send
+ * @param count Array size
+ *
+ * @return The number of datagrams sent on success or -1 if an error occurs
+ */
+int rinoo_socket_sendmmsg(t_socket *socket, t_socket_msg *msgs, int count)
+{
+	XASSERT(socket->class->sendmmsg != NULL, -1);
+	XASSERT(count > 0, -1);
+
+	return socket->class->sendmmsg(socket, msgs, count);
+}
+
 /**
  * Socket read interface for t_buffer.
  * This function waits for and reads information available on the socket.
@@ -342,9 +1014,9 @@ ssize_t rinoo_socket_readb(t_socket *socket, t_buffer *buffer)
 	if (buffer_isfull(buffer) && buffer_extend(buffer, buffer_size(buffer)) != 0) {
 		return -1;
 	}
-	res = socket->class->read(socket,
-				  buffer_ptr(buffer) + buffer_size(buffer),
-				  buffer_msize(buffer) - buffer_size(buffer));
+	res = rinoo_socket_read(socket,
+				buffer_ptr(buffer) + buffer_size(buffer),
+				buffer_msize(buffer) - buffer_size(buffer));
 	if (res <= 0) {
 		return -1;
 	}
@@ -390,9 +1062,9 @@ ssize_t rinoo_socket_readline(t_socket *socket, t_buffer *buffer, const char *de
 		if (buffer_isfull(buffer) && buffer_extend(buffer, buffer_size(buffer)) != 0) {
 			return -1;
 		}
-		res = socket->class->read(socket,
-					  buffer_ptr(buffer) + buffer_size(buffer),
-					  buffer_msize(buffer) - buffer_size(buffer));
+		res = rinoo_socket_read(socket,
+					buffer_ptr(buffer) + buffer_size(buffer),
+					buffer_msize(buffer) - buffer_size(buffer));
 		if (res <= 0) {
 			return -1;
 		}
@@ -444,7 +1116,7 @@ ssize_t rinoo_socket_writeb(t_socket *socket, t_buffer *buffer)
 	total = 0;
 	len = buffer_size(buffer);
 	while (len > 0) {
-		res = socket->class->write(socket, buffer_ptr(buffer) + buffer_size(buffer) - len, len);
+		res = rinoo_socket_write(socket, buffer_ptr(buffer) + buffer_size(buffer) - len, len);
 		if (res <= 0) {
 			return -1;
 		}
@@ -467,21 +1139,124 @@ ssize_t rinoo_socket_writeb(t_socket *socket, t_buffer *buffer)
  */
 ssize_t rinoo_socket_sendfile(t_socket *socket, int in_fd, off_t offset, size_t count)
 {
-	if (unlikely(socket->class->sendfile == NULL)) {
-		void *ptr;
-		int pagesize;
-		ssize_t result;
-		t_buffer dummy;
+	void *ptr;
+	int pagesize;
+	ssize_t result;
+	t_buffer dummy;
 
-		pagesize = getpagesize();
-		ptr = mmap(NULL, count + (offset % pagesize), PROT_READ, MAP_PRIVATE, in_fd, pagesize * (offset / pagesize));
-		if (ptr == MAP_FAILED) {
+	if (socket->coalesce.len > 0 && rinoo_socket_flush(socket) != 0) {
+		return -1;
+	}
+	if (socket->class->sendfile != NULL) {
+		result = socket->class->sendfile(socket, in_fd, offset, count);
+		if (result >= 0 || errno != EOPNOTSUPP) {
+			return result;
+		}
+	}
+	/* No sendfile for this socket, write a mapping of the file */
+	pagesize = getpagesize();
+	ptr = mmap(NULL, count + (offset % pagesize), PROT_READ, MAP_PRIVATE, in_fd, pagesize * (offset / pagesize));
+	if (ptr == MAP_FAILED) {
+		return -1;
+	}
+	buffer_static(&dummy, ptr + (offset % pagesize), count);
+	result = rinoo_socket_writeb(socket, &dummy);
+	munmap(ptr, count + (offset % pagesize));
+	return result;
+}
+
+/**
+ * Forwards data between two sockets by copying through user space.
+ *
+ * @param in Pointer to the socket to read from
+ * @param out Pointer to the socket to write to
+ * @param len Maximum number of bytes to forward
+ *
+ * @return Number of bytes forwarded or -1 if an error occurs
+ */
+static ssize_t rinoo_socket_splice_copy(t_socket *in, t_socket *out, size_t len)
+{
+	char *buf;
+	ssize_t res;
+
+	if (len > RINOO_SOCKET_SPLICE_COPY_SIZE) {
+		len = RINOO_SOCKET_SPLICE_COPY_SIZE;
+	}
+	/* Task stacks are too small for such buffers */
+	buf = malloc(len);
+	if (unlikely(buf == NULL)) {
+		return -1;
+	}
+	res = rinoo_socket_read(in, buf, len);
+	if (res > 0 && rinoo_socket_write(out, buf, res) != res) {
+		res = -1;
+	}
+	free(buf);
+	return res;
+}
+
+/**
+ * Forwards data from a socket to another without copying it to user space.
+ * This function waits for data on the input socket, moves up to len bytes
+ * to a pipe of the scheduler pool with splice(2), then to the output socket.
+ * SSL sockets, unless sending through kernel TLS, and sockets with
+ * read-ahead data fall back to a buffered copy.
+ *
+ * @param in Pointer to the socket to read from
+ * @param out Pointer to the socket to write to
+ * @param len Maximum number of bytes to forward
+ *
+ * @return Number of bytes forwarded or -1 if an error occurs (including end of stream)
+ */
+ssize_t rinoo_socket_splice(t_socket *in, t_socket *out, size_t len)
+{
+	int fds[2];
+	size_t pending;
+	ssize_t res;
+	ssize_t total;
+
+	XASSERT(in != NULL, -1);
+	XASSERT(out != NULL, -1);
+	XASSERT(len > 0, -1);
+
+	if (in->class->read == rinoo_socket_class_ssl_read ||
+	    (out->class->write == rinoo_socket_class_ssl_write && !rinoo_ssl_ktls(out)) ||
+	    in->readahead.start != in->readahead.end) {
+		return rinoo_socket_splice_copy(in, out, len);
+	}
+	if (out->coalesce.len > 0 && rinoo_socket_flush(out) != 0) {
+		return -1;
+	}
+	if (rinoo_socket_waitio(in) != 0) {
+		return -1;
+	}
+	if (rinoo_pipe_get(in->node.sched, fds) != 0) {
+		return -1;
+	}
+	errno = 0;
+	while ((res = splice(in->node.fd, NULL, fds[1], NULL, len, SPLICE_F_MOVE | SPLICE_F_NONBLOCK)) < 0) {
+		if ((errno != EAGAIN && errno != EWOULDBLOCK) || rinoo_socket_waitin(in) != 0) {
+			rinoo_pipe_release(in->node.sched, fds, true);
 			return -1;
 		}
-		buffer_static(&dummy, ptr + (offset % pagesize), count);
-		result = rinoo_socket_writeb(socket, &dummy);
-		munmap(ptr, count + (offset % pagesize));
-		return result;
+		errno = 0;
+	}
+	if (res == 0) {
+		rinoo_pipe_release(in->node.sched, fds, true);
+		return -1;
+	}
+	total = res;
+	for (pending = res; pending > 0; pending -= res) {
+		errno = 0;
+		while ((res = splice(fds[0], NULL, out->node.fd, NULL, pending, SPLICE_F_MOVE | SPLICE_F_NONBLOCK)) < 0) {
+			if ((errno != EAGAIN && errno != EWOULDBLOCK) || rinoo_socket_waitout(out) != 0) {
+				/* The pipe may still hold data */
+				rinoo_pipe_release(in->node.sched, fds, false);
+				return -1;
+			}
+			errno = 0;
+		}
 	}
-	return socket->class->sendfile(socket, in_fd, offset, count);
+	rinoo_pipe_release(in->node.sched, fds, true);
+	return total;
 }
@@ -17,13 +17,15 @@ const t_socket_class socket_class_ssl = {
 	.destroy = rinoo_socket_class_ssl_destroy,
 	.open = rinoo_socket_class_tcp_open,
 	.dup = NULL,
-	.close = rinoo_socket_class_tcp_close,
+	.close = rinoo_socket_class_ssl_close,
 	.read = rinoo_socket_class_ssl_read,
 	.recvfrom = NULL,
 	.write = rinoo_socket_class_ssl_write,
-	.writev = NULL,
+	.writev = rinoo_socket_class_ssl_writev,
 	.sendto = NULL,
-	.sendfile = NULL,
+	.sendfile = rinoo_socket_class_ssl_sendfile,
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
 	.connect = rinoo_socket_class_ssl_connect,
 	.bind = rinoo_socket_class_tcp_bind,
 	.accept = rinoo_socket_class_ssl_accept
@@ -36,13 +38,15 @@ const t_socket_class socket_class_ssl6 = {
 	.destroy = rinoo_socket_class_ssl_destroy,
 	.open = rinoo_socket_class_tcp_open,
 	.dup = NULL,
-	.close = rinoo_socket_class_tcp_close,
+	.close = rinoo_socket_class_ssl_close,
 	.read = rinoo_socket_class_ssl_read,
 	.recvfrom = NULL,
 	.write = rinoo_socket_class_ssl_write,
-	.writev = NULL,
+	.writev = rinoo_socket_class_ssl_writev,
 	.sendto = NULL,
-	.sendfile = NULL,
+	.sendfile = rinoo_socket_class_ssl_sendfile,
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
 	.connect = rinoo_socket_class_ssl_connect,
 	.bind = rinoo_socket_class_tcp_bind,
 	.accept = rinoo_socket_class_ssl_accept
@@ -59,7 +63,7 @@ t_socket *rinoo_socket_class_ssl_create(t_sched *sched)
 {
 	t_ssl *ssl;
 
-	ssl = calloc(1, sizeof(*ssl));
+	ssl = rinoo_slab_alloc(sched, sizeof(*ssl));
 	if (unlikely(ssl == NULL)) {
 		return NULL;
 	}
@@ -79,7 +83,231 @@ void rinoo_socket_class_ssl_destroy(t_socket *socket)
 	if (ssl->ssl != NULL) {
 		SSL_free(ssl->ssl);
 	}
-	free(ssl);
+	if (ssl->network != NULL) {
+		BIO_free(ssl->network);
+	}
+	free(ssl->staging);
+	rinoo_slab_free(ssl);
+}
+
+/**
+ * Closes a secure socket.
+ * A close_notify alert is sent without waiting for the peer, so that
+ * OpenSSL keeps the session resumable.
+ *
+ * @param socket Socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_class_ssl_close(t_socket *socket)
+{
+	char *ptr;
+	int len;
+	t_ssl *ssl = rinoo_ssl_get(socket);
+
+	if (ssl->ssl != NULL && SSL_is_init_finished(ssl->ssl)) {
+		SSL_shutdown(ssl->ssl);
+		ERR_clear_error();
+		if (ssl->network != NULL && (len = BIO_nread0(ssl->network, &ptr)) > 0) {
+			/* Best effort, the alert is dropped if the socket is full */
+			if (write(socket->node.fd, ptr, len) < 0) {
+				errno = 0;
+			}
+		}
+	}
+	return rinoo_socket_class_tcp_close(socket);
+}
+
+/**
+ * Writes encrypted data pending in the memory BIO ring buffer to the socket.
+ *
+ * @param ssl SSL socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_flush(t_ssl *ssl)
+{
+	int len;
+	char *ptr;
+	ssize_t ret;
+
+	while ((len = BIO_nread0(ssl->network, &ptr)) > 0) {
+		ret = write(ssl->socket.node.fd, ptr, len);
+		if (ret < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				return -1;
+			}
+			if (rinoo_socket_waitout(&ssl->socket) != 0) {
+				return -1;
+			}
+			continue;
+		}
+		BIO_nread(ssl->network, &ptr, ret);
+	}
+	return 0;
+}
+
+/**
+ * Creates the memory BIO pair of a SSL socket.
+ * Each direction is a ring buffer of the context membio size.
+ *
+ * @param ssl SSL socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_pair(t_ssl *ssl)
+{
+	BIO *internal;
+
+	if (BIO_new_bio_pair(&internal, ssl->ctx->membio, &ssl->network, ssl->ctx->membio) != 1) {
+		ssl->network = NULL;
+		return -1;
+	}
+	SSL_set_bio(ssl->ssl, internal, internal);
+	return 0;
+}
+
+/**
+ * Restores the task timer saved by rinoo_socket_class_ssl_idle.
+ *
+ * @param task Task pointer
+ * @param scheduled Whether the task was scheduled
+ * @param time Time the task was scheduled at
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_timer(t_task *task, bool scheduled, uint64_t time)
+{
+	if (scheduled) {
+		return rinoo_task_schedule_ns(task, time);
+	}
+	return rinoo_task_unschedule(task);
+}
+
+/**
+ * Waits for input while nothing is buffered.
+ * Ring buffers are kept during RINOO_SSL_MEMBIO_IDLE milliseconds, so
+ * that busy connections do not free and allocate them on every wait,
+ * then released until input comes.
+ *
+ * @param ssl SSL socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_idle(t_ssl *ssl)
+{
+	int error;
+	bool scheduled;
+	uint64_t time;
+	uint64_t idle;
+	t_task *task;
+	t_sched *sched = ssl->socket.node.sched;
+
+	task = rinoo_task_driver_getcurrent(sched);
+	scheduled = task->scheduled;
+	time = task->time;
+	idle = sched->clock + RINOO_SSL_MEMBIO_IDLE * RINOO_NSEC_PER_MSEC;
+	if (task == &sched->driver.main || (scheduled && time <= idle)) {
+		/* No idle timer: the task wakes up first anyway */
+		return rinoo_socket_waitin(&ssl->socket);
+	}
+	if (rinoo_task_schedule_ns(task, idle) != 0) {
+		return -1;
+	}
+	if (rinoo_socket_waitin(&ssl->socket) == 0) {
+		return rinoo_socket_class_ssl_timer(task, scheduled, time);
+	}
+	error = errno;
+	if (rinoo_socket_class_ssl_timer(task, scheduled, time) != 0) {
+		return -1;
+	}
+	if (error != ETIMEDOUT || (task->deadline != 0 && task->deadline <= sched->clock)) {
+		errno = error;
+		return -1;
+	}
+	/* Idle connection */
+	SSL_set_bio(ssl->ssl, NULL, NULL);
+	BIO_free(ssl->network);
+	ssl->network = NULL;
+	if (rinoo_socket_waitin(&ssl->socket) != 0) {
+		error = errno;
+		rinoo_socket_class_ssl_pair(ssl);
+		errno = error;
+		return -1;
+	}
+	return rinoo_socket_class_ssl_pair(ssl);
+}
+
+/**
+ * Reads as much as the ring buffer can hold from the socket.
+ * When nothing is buffered, the connection may be idle: ring buffers are
+ * released if no input comes for a while.
+ *
+ * @param ssl SSL socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs or the peer closed the connection
+ */
+static int rinoo_socket_class_ssl_fill(t_ssl *ssl)
+{
+	int len;
+	char *ptr;
+	ssize_t ret;
+
+	while (1) {
+		len = BIO_nwrite0(ssl->network, &ptr);
+		if (len <= 0) {
+			/* Ring buffer is full, OpenSSL has to consume it first */
+			return 0;
+		}
+		ret = read(ssl->socket.node.fd, ptr, len);
+		if (ret > 0) {
+			BIO_nwrite(ssl->network, &ptr, ret);
+			return 0;
+		}
+		if (ret == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+			return -1;
+		}
+		if (BIO_ctrl_pending(ssl->network) == 0 && BIO_ctrl_wpending(ssl->network) == 0) {
+			if (rinoo_socket_class_ssl_idle(ssl) != 0) {
+				return -1;
+			}
+		} else if (rinoo_socket_waitin(&ssl->socket) != 0) {
+			return -1;
+		}
+	}
+}
+
+/**
+ * Waits for the socket to be ready for a SSL operation to progress.
+ * With memory BIOs, pending encrypted data is written out and input is
+ * read into the ring buffer.
+ *
+ * @param ssl SSL socket pointer
+ * @param error SSL_get_error result of the operation
+ *
+ * @return 0 if the operation can be retried or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_wait(t_ssl *ssl, int error)
+{
+	switch (error) {
+	case SSL_ERROR_WANT_READ:
+		if (ssl->network == NULL) {
+			return rinoo_socket_waitin(&ssl->socket);
+		}
+		if (rinoo_socket_class_ssl_flush(ssl) != 0) {
+			return -1;
+		}
+		return rinoo_socket_class_ssl_fill(ssl);
+	case SSL_ERROR_WANT_WRITE:
+	case SSL_ERROR_WANT_CONNECT:
+	case SSL_ERROR_WANT_ACCEPT:
+		if (ssl->network == NULL) {
+			return rinoo_socket_waitout(&ssl->socket);
+		}
+		return rinoo_socket_class_ssl_flush(ssl);
+	default:
+		return -1;
+	}
 }
 
 /**
@@ -101,31 +329,13 @@ ssize_t rinoo_socket_class_ssl_read(t_socket *socket, void *buf, size_t count)
 		return -1;
 	}
 	/* Don't need to wait for input here as SSL is buffered */
-	while ((ret = SSL_read(ssl->ssl, buf, count)) < 0) {
-		switch(SSL_get_error(ssl->ssl, ret)) {
-		case SSL_ERROR_NONE:
-			return 0;
-		case SSL_ERROR_ZERO_RETURN:
-		case SSL_ERROR_WANT_X509_LOOKUP:
-		case SSL_ERROR_SYSCALL:
-		case SSL_ERROR_SSL:
+	while ((ret = SSL_read(ssl->ssl, buf, count)) <= 0) {
+		if (rinoo_socket_class_ssl_wait(ssl, SSL_get_error(ssl->ssl, ret)) != 0) {
 			return -1;
-		case SSL_ERROR_WANT_READ:
-			if (rinoo_socket_waitin(&ssl->socket) != 0) {
-				return -1;
-			}
-			break;
-		case SSL_ERROR_WANT_WRITE:
-		case SSL_ERROR_WANT_CONNECT:
-		case SSL_ERROR_WANT_ACCEPT:
-			if (rinoo_socket_waitout(&ssl->socket) != 0) {
-				return -1;
-			}
-			break;
-
 		}
 	}
-	if (ret <= 0) {
+	/* Post-handshake messages may have been produced */
+	if (ssl->network != NULL && BIO_ctrl_pending(ssl->network) > 0 && rinoo_socket_class_ssl_flush(ssl) != 0) {
 		return -1;
 	}
 	return ret;
@@ -147,35 +357,20 @@ ssize_t	rinoo_socket_class_ssl_write(t_socket *socket, const void *buf, size_t c
 	size_t sent;
 	t_ssl *ssl = rinoo_ssl_get(socket);
 
+	if (ssl->ktls_send) {
+		return rinoo_socket_class_tcp_write(socket, buf, count);
+	}
 	sent = count;
 	while (count > 0) {
 		if (rinoo_socket_waitio(socket) != 0) {
 			return -1;
 		}
-		while ((ret = SSL_write(ssl->ssl, buf, count)) < 0) {
-			switch(SSL_get_error(ssl->ssl, ret)) {
-			case SSL_ERROR_NONE:
-				return 0;
-			case SSL_ERROR_ZERO_RETURN:
-			case SSL_ERROR_WANT_X509_LOOKUP:
-			case SSL_ERROR_SYSCALL:
-			case SSL_ERROR_SSL:
+		while ((ret = SSL_write(ssl->ssl, buf, count)) <= 0) {
+			if (rinoo_socket_class_ssl_wait(ssl, SSL_get_error(ssl->ssl, ret)) != 0) {
 				return -1;
-			case SSL_ERROR_WANT_READ:
-				if (rinoo_socket_waitin(socket) != 0) {
-					return -1;
-				}
-				break;
-			case SSL_ERROR_WANT_WRITE:
-			case SSL_ERROR_WANT_CONNECT:
-			case SSL_ERROR_WANT_ACCEPT:
-				if (rinoo_socket_waitout(socket) != 0) {
-					return -1;
-				}
-				break;
 			}
 		}
-		if (ret <= 0) {
+		if (ssl->network != NULL && rinoo_socket_class_ssl_flush(ssl) != 0) {
 			return -1;
 		}
 		count -= ret;
@@ -185,62 +380,195 @@ ssize_t	rinoo_socket_class_ssl_write(t_socket *socket, const void *buf, size_t c
 }
 
 /**
- * Replacement to the connect(2) syscall.
+ * Gather write for secure sockets. Buffers are packed into full size TLS
+ * records through a per-connection staging buffer, so that small buffers
+ * do not each produce their own record. Data of a full record size which
+ * is not preceded by staged data is written directly.
  *
- * @param socket Pointer to the socket to connect.
- * @param addr Pointer to a sockaddr structure (see man connect)
- * @param addrlen Sockaddr structure size (see man connect)
+ * @param socket Pointer to the socket to write to
+ * @param buffers Array of buffers
+ * @param count Array size
  *
- * @return 0 on success or -1 if an error occurs (timeout is considered as an error)
+ * @return The number of bytes written on success or -1 if an error occurs
  */
-int rinoo_socket_class_ssl_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen)
+ssize_t rinoo_socket_class_ssl_writev(t_socket *socket, t_buffer **buffers, int count)
 {
-	int ret;
-	BIO *sbio;
+	int i;
+	char *ptr;
+	size_t len;
+	size_t size;
+	size_t staged;
+	ssize_t total;
 	t_ssl *ssl = rinoo_ssl_get(socket);
 
-	if (unlikely(rinoo_socket_class_tcp_connect(socket, addr, addrlen) != 0)) {
+	if (ssl->ktls_send) {
+		/* The kernel builds full records itself */
+		return rinoo_socket_class_tcp_writev(socket, buffers, count);
+	}
+	total = 0;
+	staged = 0;
+	for (i = 0; i < count; i++) {
+		ptr = buffer_ptr(buffers[i]);
+		len = buffer_size(buffers[i]);
+		while (len > 0) {
+			if (staged == 0 && len >= RINOO_SSL_RECORD_SIZE) {
+				/* Full records straight from the caller buffer */
+				size = len - len % RINOO_SSL_RECORD_SIZE;
+				if (rinoo_socket_class_ssl_write(socket, ptr, size) < 0) {
+					return -1;
+				}
+			} else {
+				if (ssl->staging == NULL) {
+					ssl->staging = malloc(RINOO_SSL_RECORD_SIZE);
+					if (unlikely(ssl->staging == NULL)) {
+						return -1;
+					}
+				}
+				size = RINOO_SSL_RECORD_SIZE - staged;
+				if (size > len) {
+					size = len;
+				}
+				memcpy(ssl->staging + staged, ptr, size);
+				staged += size;
+				if (staged == RINOO_SSL_RECORD_SIZE) {
+					if (rinoo_socket_class_ssl_write(socket, ssl->staging, staged) < 0) {
+						return -1;
+					}
+					staged = 0;
+				}
+			}
+			ptr += size;
+			len -= size;
+			total += size;
+		}
+	}
+	if (staged > 0 && rinoo_socket_class_ssl_write(socket, ssl->staging, staged) < 0) {
 		return -1;
 	}
-	ssl->ssl = SSL_new(ssl->ctx->ctx);
-	if (unlikely(ssl->ssl == NULL)) {
+	return total;
+}
+
+/**
+ * Replacement function for sendfile(2) on secure sockets.
+ * This only works with kernel TLS, file content being encrypted by the kernel.
+ *
+ * @param socket Pointer to the socket to send the file to
+ * @param in_fd File descriptor of file to send
+ * @param offset File offset
+ * @param count Number of bytes to send
+ *
+ * @return Number of bytes sent or -1 if an error occurs (EOPNOTSUPP without kernel TLS)
+ */
+ssize_t rinoo_socket_class_ssl_sendfile(t_socket *socket, int in_fd, off_t offset, size_t count)
+{
+	if (!rinoo_ssl_get(socket)->ktls_send) {
+		errno = EOPNOTSUPP;
 		return -1;
 	}
+	return rinoo_socket_class_tcp_sendfile(socket, in_fd, offset, count);
+}
+
+/**
+ * Attaches BIOs to a new SSL connection: memory BIOs when the context
+ * enables them, otherwise a socket BIO.
+ *
+ * @param ssl SSL socket pointer
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_bio(t_ssl *ssl)
+{
+	BIO *sbio;
+
+	if (ssl->ctx->membio > 0) {
+		return rinoo_socket_class_ssl_pair(ssl);
+	}
 	sbio = BIO_new_socket(ssl->socket.node.fd, BIO_NOCLOSE);
 	if (unlikely(sbio == NULL)) {
 		return -1;
 	}
 	SSL_set_bio(ssl->ssl, sbio, sbio);
-	while ((ret = SSL_connect(ssl->ssl)) < 0) {
-		switch(SSL_get_error(ssl->ssl, ret)) {
-		case SSL_ERROR_NONE:
-			return 0;
-		case SSL_ERROR_ZERO_RETURN:
-		case SSL_ERROR_WANT_X509_LOOKUP:
-		case SSL_ERROR_SYSCALL:
-		case SSL_ERROR_SSL:
-			return -1;
-		case SSL_ERROR_WANT_READ:
-			if (rinoo_socket_waitin(&ssl->socket) != 0) {
-				return -1;
-			}
+	return 0;
+}
+
+/**
+ * Performs a TLS handshake, on a worker thread when the context has an
+ * offload pool.
+ *
+ * @param ssl SSL socket with its connect or accept state set
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_socket_class_ssl_handshake(t_ssl *ssl)
+{
+	int ret;
+	int error;
+	t_ssl_offload_job job;
+	t_ssl_offload *offload = ssl->ctx->offload;
+
+	if (offload != NULL && rinoo_ssl_offload_job(&job, ssl->socket.node.sched, ssl->ssl) != 0) {
+		return -1;
+	}
+	while (1) {
+		if (offload != NULL) {
+			ret = rinoo_ssl_offload_handshake(offload, &job, &error);
+		} else {
+			ret = SSL_do_handshake(ssl->ssl);
+			error = SSL_get_error(ssl->ssl, ret);
+		}
+		if (ret == 1) {
 			break;
-		case SSL_ERROR_WANT_WRITE:
-		case SSL_ERROR_WANT_CONNECT:
-		case SSL_ERROR_WANT_ACCEPT:
-			if (rinoo_socket_waitout(&ssl->socket) != 0) {
-				return -1;
+		}
+		if (rinoo_socket_class_ssl_wait(ssl, error) != 0) {
+			if (offload != NULL) {
+				error = errno;
+				rinoo_ssl_offload_job_destroy(&job);
+				errno = error;
 			}
-			break;
-
+			return -1;
 		}
 	}
-	if (ret == 0) {
+	if (offload != NULL) {
+		rinoo_ssl_offload_job_destroy(&job);
+	}
+	if (ssl->network != NULL && rinoo_socket_class_ssl_flush(ssl) != 0) {
 		return -1;
 	}
+#ifdef RINOO_SSL_KTLS
+	ssl->ktls_send = BIO_get_ktls_send(SSL_get_wbio(ssl->ssl));
+#endif /* !RINOO_SSL_KTLS */
+	rinoo_ssl_session_count(&ssl->socket);
 	return 0;
 }
 
+/**
+ * Replacement to the connect(2) syscall.
+ *
+ * @param socket Pointer to the socket to connect.
+ * @param addr Pointer to a sockaddr structure (see man connect)
+ * @param addrlen Sockaddr structure size (see man connect)
+ *
+ * @return 0 on success or -1 if an error occurs (timeout is considered as an error)
+ */
+int rinoo_socket_class_ssl_connect(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen)
+{
+	t_ssl *ssl = rinoo_ssl_get(socket);
+
+	if (unlikely(rinoo_socket_class_tcp_connect(socket, addr, addrlen) != 0)) {
+		return -1;
+	}
+	ssl->ssl = SSL_new(ssl->ctx->ctx);
+	if (unlikely(ssl->ssl == NULL)) {
+		return -1;
+	}
+	if (unlikely(rinoo_socket_class_ssl_bio(ssl) != 0)) {
+		return -1;
+	}
+	rinoo_ssl_session_resume(socket, addr, addrlen);
+	SSL_set_connect_state(ssl->ssl);
+	return rinoo_socket_class_ssl_handshake(ssl);
+}
+
 /**
  * Accepts a new connection from a listening socket.
  * This is a replacement to the accept(2) syscall in this library.
@@ -254,8 +582,6 @@ int rinoo_socket_class_ssl_connect(t_socket *socket, const struct sockaddr *addr
 t_socket *rinoo_socket_class_ssl_accept(t_socket *socket, struct sockaddr *addr, socklen_t *addrlen)
 {
 	int fd;
-	int ret;
-	BIO *sbio;
 	t_ssl *new;
 	t_ssl *ssl = rinoo_ssl_get(socket);
 
@@ -280,7 +606,7 @@ t_socket *rinoo_socket_class_ssl_accept(t_socket *socket, struct sockaddr *addr,
 		}
 		errno = 0;
 	}
-	new = calloc(1, sizeof(*new));
+	new = rinoo_slab_alloc(socket->node.sched, sizeof(*new));
 	if (unlikely(new == NULL)) {
 		close(fd);
 		return NULL;
@@ -290,42 +616,23 @@ t_socket *rinoo_socket_class_ssl_accept(t_socket *socket, struct sockaddr *addr,
 	new->socket.node.sched = socket->node.sched;
 	new->socket.class = socket->class;
 	new->socket.parent = socket;
+	if (rinoo_socket_inherit(&new->socket, socket) != 0) {
+		rinoo_socket_destroy(&new->socket);
+		return NULL;
+	}
 	new->ssl = SSL_new(new->ctx->ctx);
 	if (unlikely(new->ssl == NULL)) {
 		rinoo_socket_destroy(&new->socket);
 		return NULL;
 	}
-	sbio = BIO_new_socket(new->socket.node.fd, BIO_NOCLOSE);
-	if (unlikely(sbio == NULL)) {
+	if (unlikely(rinoo_socket_class_ssl_bio(new) != 0)) {
 		rinoo_socket_destroy(&new->socket);
 		return NULL;
 	}
-	SSL_set_bio(new->ssl, sbio, sbio);
-	while ((ret = SSL_accept(new->ssl)) <= 0) {
-		switch(SSL_get_error(new->ssl, ret)) {
-		case SSL_ERROR_NONE:
-		case SSL_ERROR_ZERO_RETURN:
-		case SSL_ERROR_WANT_X509_LOOKUP:
-		case SSL_ERROR_SYSCALL:
-		case SSL_ERROR_SSL:
-			rinoo_socket_destroy(&new->socket);
-			return NULL;
-		case SSL_ERROR_WANT_READ:
-			if (rinoo_socket_waitin(&new->socket) != 0) {
-				rinoo_socket_destroy(&new->socket);
-				return NULL;
-			}
-			break;
-		case SSL_ERROR_WANT_WRITE:
-		case SSL_ERROR_WANT_CONNECT:
-		case SSL_ERROR_WANT_ACCEPT:
-			if (rinoo_socket_waitout(&new->socket) != 0) {
-				rinoo_socket_destroy(&new->socket);
-				return NULL;
-			}
-			break;
-
-		}
+	SSL_set_accept_state(new->ssl);
+	if (rinoo_socket_class_ssl_handshake(new) != 0) {
+		rinoo_socket_destroy(&new->socket);
+		return NULL;
 	}
 	return &new->socket;
 }
@@ -24,6 +24,8 @@ const t_socket_class socket_class_tcp = {
 	.writev = rinoo_socket_class_tcp_writev,
 	.sendto = rinoo_socket_class_tcp_sendto,
 	.sendfile = rinoo_socket_class_tcp_sendfile,
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
 	.connect = rinoo_socket_class_tcp_connect,
 	.bind = rinoo_socket_class_tcp_bind,
 	.accept = rinoo_socket_class_tcp_accept
@@ -43,6 +45,8 @@ const t_socket_class socket_class_tcp6 = {
 	.writev = rinoo_socket_class_tcp_writev,
 	.sendto = rinoo_socket_class_tcp_sendto,
 	.sendfile = rinoo_socket_class_tcp_sendfile,
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
 	.connect = rinoo_socket_class_tcp_connect,
 	.bind = rinoo_socket_class_tcp_bind,
 	.accept = rinoo_socket_class_tcp_accept
@@ -59,7 +63,7 @@ t_socket *rinoo_socket_class_tcp_create(t_sched *sched)
 {
 	t_socket *socket;
 
-	socket = calloc(1, sizeof(*socket));
+	socket = rinoo_slab_alloc(sched, sizeof(*socket));
 	if (unlikely(socket == NULL)) {
 		return NULL;
 	}
@@ -74,7 +78,7 @@ t_socket *rinoo_socket_class_tcp_create(t_sched *sched)
  */
 void rinoo_socket_class_tcp_destroy(t_socket *socket)
 {
-	free(socket);
+	rinoo_slab_free(socket);
 }
 
 /**
@@ -116,14 +120,14 @@ t_socket *rinoo_socket_class_tcp_dup(t_sched *destination, t_socket *socket)
 {
 	t_socket *new;
 
-	new = calloc(1, sizeof(*new));
+	new = rinoo_slab_alloc(destination, sizeof(*new));
 	if (unlikely(new == NULL)) {
 		return NULL;
 	}
 	*new = *socket;
 	new->node.fd = dup(socket->node.fd);
 	if (unlikely(new->node.fd < 0)) {
-		free(new);
+		rinoo_slab_free(new);
 		return NULL;
 	}
 	new->node.sched = destination;
@@ -215,6 +219,7 @@ ssize_t rinoo_socket_class_tcp_recvfrom(t_socket *socket, void *buf, size_t coun
 /**
  * Replacement to the write(2) syscall in this library.
  * This function waits for the socket to be available for write operations and calls the write(2) syscall.
+ * Writes above the socket zerocopy threshold use MSG_ZEROCOPY and wait for the kernel to release buf.
  *
  * @param socket Pointer to the socket to read
  * @param buf Buffer which stores the information to write
@@ -224,36 +229,57 @@ ssize_t rinoo_socket_class_tcp_recvfrom(t_socket *socket, void *buf, size_t coun
  */
 ssize_t	rinoo_socket_class_tcp_write(t_socket *socket, const void *buf, size_t count)
 {
+	int flags;
 	size_t sent;
 	ssize_t ret;
 
+	flags = 0;
+	if (socket->zerocopy.threshold != 0 && count >= socket->zerocopy.threshold) {
+		flags = MSG_ZEROCOPY;
+	}
 	sent = count;
 	while (count > 0) {
 		if (rinoo_socket_waitio(socket) != 0) {
 			return -1;
 		}
 		errno = 0;
-		ret = write(socket->node.fd, buf, count);
+		if (flags != 0) {
+			ret = send(socket->node.fd, buf, count, flags);
+		} else {
+			ret = write(socket->node.fd, buf, count);
+		}
 		if (ret == 0) {
 			return -1;
 		} else if (ret < 0) {
-			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			if (errno == ENOBUFS && flags != 0) {
+				/* Out of pinned memory, copy the remaining data */
+				flags = 0;
+				continue;
+			}
+			/* EINPROGRESS: deferred Fast Open connection still in progress */
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINPROGRESS) {
 				return -1;
 			}
 			if (rinoo_socket_waitout(socket) != 0) {
 				return -1;
 			}
 			ret = 0;
+		} else if (flags != 0) {
+			socket->zerocopy.sent++;
 		}
 		count -= ret;
 		buf += ret;
 	}
+	if (socket->zerocopy.sent != socket->zerocopy.completed && rinoo_socket_zerocopy_wait(socket) != 0) {
+		return -1;
+	}
 	return sent;
 }
 
 /**
  * Replacement to the writev(2) syscall in this library.
  * This function waits for the socket to be available for write operations and calls the write(2) syscall.
+ * Writes above the socket zerocopy threshold use MSG_ZEROCOPY and wait for the kernel to release buffers.
  *
  * @param socket Pointer to the socket to read
  * @param buffers Array of buffers
@@ -264,9 +290,11 @@ ssize_t	rinoo_socket_class_tcp_write(t_socket *socket, const void *buf, size_t c
 ssize_t	rinoo_socket_class_tcp_writev(t_socket *socket, t_buffer **buffers, int count)
 {
 	int i;
+	int flags;
 	ssize_t ret;
 	ssize_t sent;
 	size_t total;
+	struct msghdr msg;
 	struct iovec *iov;
 
 	if (count > IOV_MAX) {
@@ -279,23 +307,41 @@ ssize_t	rinoo_socket_class_tcp_writev(t_socket *socket, t_buffer **buffers, int
 		iov[i].iov_len = buffer_size(buffers[i]);
 		total += buffer_size(buffers[i]);
 	}
+	flags = 0;
+	if (socket->zerocopy.threshold != 0 && total >= socket->zerocopy.threshold) {
+		flags = MSG_ZEROCOPY;
+	}
 	sent = 0;
 	while (count > 0) {
 		if (rinoo_socket_waitio(socket) != 0) {
 			return -1;
 		}
 		errno = 0;
-		ret = writev(socket->node.fd, iov, count);
+		if (flags != 0) {
+			memset(&msg, 0, sizeof(msg));
+			msg.msg_iov = iov;
+			msg.msg_iovlen = count;
+			ret = sendmsg(socket->node.fd, &msg, flags);
+		} else {
+			ret = writev(socket->node.fd, iov, count);
+		}
 		if (ret == 0) {
 			return -1;
 		} else if (ret < 0) {
-			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			if (errno == ENOBUFS && flags != 0) {
+				/* Out of pinned memory, copy the remaining data */
+				flags = 0;
+				continue;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINPROGRESS) {
 				return -1;
 			}
 			if (rinoo_socket_waitout(socket) != 0) {
 				return -1;
 			}
 			ret = 0;
+		} else if (flags != 0) {
+			socket->zerocopy.sent++;
 		}
 		sent += ret;
 		if (((size_t) sent) == total) {
@@ -313,6 +359,9 @@ ssize_t	rinoo_socket_class_tcp_writev(t_socket *socket, t_buffer **buffers, int
 		}
 		count -= i;
 	}
+	if (socket->zerocopy.sent != socket->zerocopy.completed && rinoo_socket_zerocopy_wait(socket) != 0) {
+		return -1;
+	}
 	return sent;
 }
 
@@ -454,6 +503,34 @@ int rinoo_socket_class_tcp_bind(t_socket *socket, const struct sockaddr *addr, s
 	return 0;
 }
 
+/**
+ * Allocates a socket for a connection accepted on a listening socket.
+ *
+ * @param socket Pointer to the listening socket
+ * @param fd Accepted file descriptor
+ *
+ * @return Pointer to the new socket or NULL if an error occurs
+ */
+static t_socket *rinoo_socket_class_tcp_accepted(t_socket *socket, int fd)
+{
+	t_socket *new;
+
+	new = rinoo_slab_alloc(socket->node.sched, sizeof(*new));
+	if (unlikely(new == NULL)) {
+		return NULL;
+	}
+	new->node.fd = fd;
+	new->node.sched = socket->node.sched;
+	new->parent = socket;
+	new->class = socket->class;
+	if (rinoo_socket_inherit(new, socket) != 0) {
+		/* The caller closes fd */
+		rinoo_slab_free(new);
+		return NULL;
+	}
+	return new;
+}
+
 /**
  * Accepts a new connection from a listening socket.
  * This is a replacement to the accept(2) syscall in this library.
@@ -493,14 +570,67 @@ t_socket *rinoo_socket_class_tcp_accept(t_socket *socket, struct sockaddr *addr,
 		}
 		errno = 0;
 	}
-	new = calloc(1, sizeof(*new));
+	new = rinoo_socket_class_tcp_accepted(socket, fd);
 	if (unlikely(new == NULL)) {
 		close(fd);
 		return NULL;
 	}
-	new->node.fd = fd;
-	new->node.sched = socket->node.sched;
-	new->parent = socket;
-	new->class = socket->class;
 	return new;
 }
+
+/**
+ * Accepts every pending connection of a listening socket, up to count.
+ * The task only waits for connections when none is pending, then the
+ * backlog is drained until accept4(2) returns EAGAIN.
+ *
+ * @param socket Pointer to the listening socket
+ * @param sockets Array where to store accepted sockets
+ * @param count Array size
+ *
+ * @return The number of accepted sockets on success or -1 if an error occurs
+ */
+int rinoo_socket_class_tcp_accept_many(t_socket *socket, t_socket **sockets, int count)
+{
+	int fd;
+	int nbsockets;
+
+	if (rinoo_socket_waitio(socket) != 0) {
+		return -1;
+	}
+	nbsockets = 0;
+	while (nbsockets < count) {
+		errno = 0;
+		fd = accept4(socket->node.fd, NULL, NULL, SOCK_NONBLOCK);
+		if (fd < 0) {
+			switch (errno) {
+				case ENETDOWN:
+				case EPROTO:
+				case ENOPROTOOPT:
+				case EHOSTDOWN:
+				case ENONET:
+				case EHOSTUNREACH:
+				case EOPNOTSUPP:
+				case ENETUNREACH:
+					/* This connection failed, try the next one */
+					continue;
+				case EAGAIN:
+					if (nbsockets > 0) {
+						return nbsockets;
+					}
+					if (rinoo_socket_waitin(socket) != 0) {
+						return -1;
+					}
+					continue;
+				default:
+					return (nbsockets > 0 ? nbsockets : -1);
+			}
+		}
+		sockets[nbsockets] = rinoo_socket_class_tcp_accepted(socket, fd);
+		if (unlikely(sockets[nbsockets] == NULL)) {
+			close(fd);
+			return (nbsockets > 0 ? nbsockets : -1);
+		}
+		nbsockets++;
+	}
+	return nbsockets;
+}
@@ -24,6 +24,8 @@ const t_socket_class socket_class_udp = {
 	.writev = rinoo_socket_class_udp_writev,
 	.sendto = rinoo_socket_class_udp_sendto,
 	.sendfile = NULL,
+	.recvmmsg = rinoo_socket_class_udp_recvmmsg,
+	.sendmmsg = rinoo_socket_class_udp_sendmmsg,
 	.connect = rinoo_socket_class_udp_connect,
 	.bind = rinoo_socket_class_udp_bind,
 	.accept = NULL
@@ -43,6 +45,8 @@ const t_socket_class socket_class_udp6 = {
 	.writev = rinoo_socket_class_udp_writev,
 	.sendto = rinoo_socket_class_udp_sendto,
 	.sendfile = NULL,
+	.recvmmsg = rinoo_socket_class_udp_recvmmsg,
+	.sendmmsg = rinoo_socket_class_udp_sendmmsg,
 	.connect = rinoo_socket_class_udp_connect,
 	.bind = rinoo_socket_class_udp_bind,
 	.accept = NULL
@@ -59,7 +63,7 @@ t_socket *rinoo_socket_class_udp_create(t_sched *sched)
 {
 	t_socket *socket;
 
-	socket = calloc(1, sizeof(*socket));
+	socket = rinoo_slab_alloc(sched, sizeof(*socket));
 	if (unlikely(socket == NULL)) {
 		return NULL;
 	}
@@ -74,7 +78,7 @@ t_socket *rinoo_socket_class_udp_create(t_sched *sched)
  */
 void rinoo_socket_class_udp_destroy(t_socket *socket)
 {
-	free(socket);
+	rinoo_slab_free(socket);
 }
 
 /**
@@ -116,14 +120,14 @@ t_socket *rinoo_socket_class_udp_dup(t_sched *destination, t_socket *socket)
 {
 	t_socket *new;
 
-	new = calloc(1, sizeof(*new));
+	new = rinoo_slab_alloc(destination, sizeof(*new));
 	if (unlikely(new == NULL)) {
 		return NULL;
 	}
 	*new = *socket;
 	new->node.fd = dup(socket->node.fd);
 	if (unlikely(new->node.fd < 0)) {
-		free(new);
+		rinoo_slab_free(new);
 		return NULL;
 	}
 	new->node.sched = destination;
@@ -356,6 +360,130 @@ ssize_t rinoo_socket_class_udp_sendto(t_socket *socket, void *buf, size_t count,
 	return sent;
 }
 
+/**
+ * Replacement to the recvmmsg(2) syscall in this library.
+ * This function waits for the socket to be available for read operations
+ * and receives up to count datagrams, RINOO_SOCKET_MMSG_MAX per syscall.
+ * Each datagram replaces the content of its message buffer, peer address
+ * is stored in the message addr and addrlen.
+ *
+ * @param socket Pointer to the socket to read
+ * @param msgs Array of messages to fill
+ * @param count Array size
+ *
+ * @return The number of datagrams received on success or -1 if an error occurs
+ */
+int rinoo_socket_class_udp_recvmmsg(t_socket *socket, t_socket_msg *msgs, int count)
+{
+	int i;
+	int ret;
+	int nbmsg;
+	int received;
+	struct iovec iov[RINOO_SOCKET_MMSG_MAX];
+	struct mmsghdr hdr[RINOO_SOCKET_MMSG_MAX];
+
+	if (rinoo_socket_waitio(socket) != 0) {
+		return -1;
+	}
+	received = 0;
+	while (received < count) {
+		nbmsg = count - received;
+		if (nbmsg > RINOO_SOCKET_MMSG_MAX) {
+			nbmsg = RINOO_SOCKET_MMSG_MAX;
+		}
+		memset(hdr, 0, sizeof(*hdr) * nbmsg);
+		for (i = 0; i < nbmsg; i++) {
+			iov[i].iov_base = buffer_ptr(msgs[received + i].buffer);
+			iov[i].iov_len = buffer_msize(msgs[received + i].buffer);
+			hdr[i].msg_hdr.msg_iov = &iov[i];
+			hdr[i].msg_hdr.msg_iovlen = 1;
+			hdr[i].msg_hdr.msg_name = &msgs[received + i].addr;
+			hdr[i].msg_hdr.msg_namelen = sizeof(msgs[received + i].addr);
+		}
+		errno = 0;
+		ret = recvmmsg(socket->node.fd, hdr, nbmsg, MSG_DONTWAIT, NULL);
+		if (ret < 0) {
+			if (received > 0) {
+				/* Report what has been received, errors come back on next call */
+				break;
+			}
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				return -1;
+			}
+			if (rinoo_socket_waitin(socket) != 0) {
+				return -1;
+			}
+			continue;
+		}
+		for (i = 0; i < ret; i++) {
+			buffer_setsize(msgs[received + i].buffer, hdr[i].msg_len);
+			msgs[received + i].addrlen = hdr[i].msg_hdr.msg_namelen;
+		}
+		received += ret;
+		if (ret < nbmsg) {
+			break;
+		}
+	}
+	return received;
+}
+
+/**
+ * Replacement to the sendmmsg(2) syscall in this library.
+ * This function sends every message buffer as one datagram, waiting for
+ * the socket to be available for write operations when needed.
+ * A message addrlen of 0 sends to the connected peer.
+ *
+ * @param socket Pointer to the socket to write
+ * @param msgs Array of messages to send
+ * @param count Array size
+ *
+ * @return The number of datagrams sent on success or -1 if an error occurs
+ */
+int rinoo_socket_class_udp_sendmmsg(t_socket *socket, t_socket_msg *msgs, int count)
+{
+	int i;
+	int ret;
+	int nbmsg;
+	int sent;
+	struct iovec iov[RINOO_SOCKET_MMSG_MAX];
+	struct mmsghdr hdr[RINOO_SOCKET_MMSG_MAX];
+
+	sent = 0;
+	while (sent < count) {
+		if (rinoo_socket_waitio(socket) != 0) {
+			return -1;
+		}
+		nbmsg = count - sent;
+		if (nbmsg > RINOO_SOCKET_MMSG_MAX) {
+			nbmsg = RINOO_SOCKET_MMSG_MAX;
+		}
+		memset(hdr, 0, sizeof(*hdr) * nbmsg);
+		for (i = 0; i < nbmsg; i++) {
+			iov[i].iov_base = buffer_ptr(msgs[sent + i].buffer);
+			iov[i].iov_len = buffer_size(msgs[sent + i].buffer);
+			hdr[i].msg_hdr.msg_iov = &iov[i];
+			hdr[i].msg_hdr.msg_iovlen = 1;
+			if (msgs[sent + i].addrlen > 0) {
+				hdr[i].msg_hdr.msg_name = &msgs[sent + i].addr;
+				hdr[i].msg_hdr.msg_namelen = msgs[sent + i].addrlen;
+			}
+		}
+		errno = 0;
+		ret = sendmmsg(socket->node.fd, hdr, nbmsg, MSG_DONTWAIT);
+		if (ret < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				return -1;
+			}
+			if (rinoo_socket_waitout(socket) != 0) {
+				return -1;
+			}
+			ret = 0;
+		}
+		sent += ret;
+	}
+	return sent;
+}
+
 /**
  * Replacement to the connect(2) syscall.
  *
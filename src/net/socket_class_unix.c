@@ -0,0 +1,96 @@
+/**
+ * @file   socket_class_unix.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 20:16:02 2026
+ *
+ * @brief  Unix domain socket classes
+ *
+ * Unix sockets behave like TCP and UDP sockets for I/O, so these
+ * classes reuse their functions. Only binding differs, as
+ * SO_REUSEPORT is not supported on AF_UNIX.
+ *
+ */
+
+#include "rinoo/net/module.h"
+
+const t_socket_class socket_class_unix = {
+	.domain = AF_UNIX,
+	.type = SOCK_STREAM,
+	.create = rinoo_socket_class_tcp_create,
+	.destroy = rinoo_socket_class_tcp_destroy,
+	.open = rinoo_socket_class_tcp_open,
+	.dup = rinoo_socket_class_tcp_dup,
+	.close = rinoo_socket_class_tcp_close,
+	.read = rinoo_socket_class_tcp_read,
+	.recvfrom = rinoo_socket_class_tcp_recvfrom,
+	.write = rinoo_socket_class_tcp_write,
+	.writev = rinoo_socket_class_tcp_writev,
+	.sendto = rinoo_socket_class_tcp_sendto,
+	.sendfile = rinoo_socket_class_tcp_sendfile,
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
+	.connect = rinoo_socket_class_tcp_connect,
+	.bind = rinoo_socket_class_unix_bind,
+	.accept = rinoo_socket_class_tcp_accept
+};
+
+const t_socket_class socket_class_unix_dgram = {
+	.domain = AF_UNIX,
+	.type = SOCK_DGRAM,
+	.create = rinoo_socket_class_udp_create,
+	.destroy = rinoo_socket_class_udp_destroy,
+	.open = rinoo_socket_class_udp_open,
+	.dup = rinoo_socket_class_udp_dup,
+	.close = rinoo_socket_class_udp_close,
+	.read = rinoo_socket_class_udp_read,
+	.recvfrom = rinoo_socket_class_udp_recvfrom,
+	.write = rinoo_socket_class_udp_write,
+	.writev = rinoo_socket_class_udp_writev,
+	.sendto = rinoo_socket_class_udp_sendto,
+	.sendfile = NULL,
+	/* t_socket_msg only holds IP addresses */
+	.recvmmsg = NULL,
+	.sendmmsg = NULL,
+	.connect = rinoo_socket_class_udp_connect,
+	.bind = rinoo_socket_class_unix_dgram_bind,
+	.accept = NULL
+};
+
+/**
+ * Marks the specified unix socket to be listening to new connection.
+ * Additionally, this function will bind the socket to the specified addr info.
+ * This is a replacement of the listen(2) syscall in this library.
+ *
+ * @param socket Pointer to the socket to listen to
+ * @param addr Pointer to a sockaddr_un structure (see man listen)
+ * @param addrlen Sockaddr structure size (see man listen)
+ * @param backlog Maximum listening queue size (see man listen)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_class_unix_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int backlog)
+{
+	if (bind(socket->node.fd, addr, addrlen) == -1) {
+		return -1;
+	}
+	if (listen(socket->node.fd, backlog) == -1) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Binds the unix datagram socket to the specified addr info.
+ * This is a replacement of the bind(2) syscall in this library.
+ *
+ * @param socket Pointer to the socket to bind
+ * @param addr Pointer to a sockaddr_un structure (see man bind)
+ * @param addrlen Sockaddr structure size (see man bind)
+ * @param backlog Ignored
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_socket_class_unix_dgram_bind(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen, int unused(backlog))
+{
+	return bind(socket->node.fd, addr, addrlen);
+}
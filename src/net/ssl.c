@@ -13,38 +13,157 @@
 extern const t_socket_class socket_class_ssl;
 extern const t_socket_class socket_class_ssl6;
 
+typedef struct s_ssl_session {
+	t_ip peer;
+	SSL_SESSION *session;
+	t_htable_node node;
+} t_ssl_session;
+
+static uint32_t rinoo_ssl_session_hash(t_htable_node *node)
+{
+	uint32_t hash;
+	t_ssl_session *session = container_of(node, t_ssl_session, node);
+
+	murmurhash3_x86_32(&session->peer, sizeof(session->peer), 0, &hash);
+	return hash;
+}
+
+static int rinoo_ssl_session_cmp(t_htable_node *node1, t_htable_node *node2)
+{
+	t_ssl_session *session1 = container_of(node1, t_ssl_session, node);
+	t_ssl_session *session2 = container_of(node2, t_ssl_session, node);
+
+	return memcmp(&session1->peer, &session2->peer, sizeof(session1->peer));
+}
+
+static void rinoo_ssl_session_free(t_htable_node *node)
+{
+	t_ssl_session *session = container_of(node, t_ssl_session, node);
+
+	SSL_SESSION_free(session->session);
+	free(session);
+}
+
+static uint32_t rinoo_ssl_context_hash(t_htable_node *node)
+{
+	uint32_t hash;
+	t_ssl_ctx *ctx = container_of(node, t_ssl_ctx, node);
+
+	murmurhash3_x86_32(ctx->id, strlen(ctx->id), 0, &hash);
+	return hash;
+}
+
+static int rinoo_ssl_context_cmp(t_htable_node *node1, t_htable_node *node2)
+{
+	t_ssl_ctx *ctx1 = container_of(node1, t_ssl_ctx, node);
+	t_ssl_ctx *ctx2 = container_of(node2, t_ssl_ctx, node);
+
+	return strcmp(ctx1->id, ctx2->id);
+}
+
+/* Contexts loaded from files, shared by every caller using the same files and options */
+static pthread_mutex_t contexts_mutex = PTHREAD_MUTEX_INITIALIZER;
+static t_htable contexts = { .table = NULL };
+
 /**
- * Creates a simple SSL context.
+ * Wraps an OpenSSL context.
  *
+ * @param ctx OpenSSL context, freed on error
  *
- * @return SSL context pointer
+ * @return SSL context pointer or NULL if an error occurs
  */
-t_ssl_ctx *rinoo_ssl_context(void)
+static t_ssl_ctx *rinoo_ssl_context_new(SSL_CTX *ctx)
+{
+	t_ssl_ctx *ssl;
+
+	ssl = calloc(1, sizeof(*ssl));
+	if (ssl == NULL) {
+		SSL_CTX_free(ctx);
+		return NULL;
+	}
+	ssl->ctx = ctx;
+	ssl->refs = 1;
+	pthread_mutex_init(&ssl->mutex, NULL);
+	SSL_CTX_set_app_data(ctx, ssl);
+	return ssl;
+}
+
+/**
+ * Takes a context out of the file cache before it gets customized, so
+ * that later loads of the same files get a fresh context.
+ *
+ * @param ctx SSL context pointer
+ *
+ * @return 0 on success or -1 if other callers share the context (EBUSY)
+ */
+static int rinoo_ssl_context_detach(t_ssl_ctx *ctx)
+{
+	if (ctx->id == NULL) {
+		return 0;
+	}
+	pthread_mutex_lock(&contexts_mutex);
+	if (ctx->refs > 1) {
+		pthread_mutex_unlock(&contexts_mutex);
+		errno = EBUSY;
+		return -1;
+	}
+	htable_remove(&contexts, &ctx->node);
+	pthread_mutex_unlock(&contexts_mutex);
+	free(ctx->id);
+	ctx->id = NULL;
+	return 0;
+}
+
+/**
+ * Applies protocol versions, cipher lists and key exchange groups.
+ *
+ * @param ctx OpenSSL context
+ * @param options Options, NULL for defaults
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_ssl_context_options(SSL_CTX *ctx, const t_ssl_options *options)
+{
+	const char *groups;
+
+	groups = (options != NULL && options->groups != NULL ? options->groups : RINOO_SSL_GROUPS);
+	if (SSL_CTX_set_min_proto_version(ctx, (options != NULL && options->tls13_only ? TLS1_3_VERSION : TLS1_2_VERSION)) != 1) {
+		return -1;
+	}
+	if (SSL_CTX_set1_groups_list(ctx, groups) != 1) {
+		return -1;
+	}
+	if (options == NULL) {
+		return 0;
+	}
+	if (options->ciphers != NULL && SSL_CTX_set_cipher_list(ctx, options->ciphers) != 1) {
+		return -1;
+	}
+	if (options->ciphersuites != NULL && SSL_CTX_set_ciphersuites(ctx, options->ciphersuites) != 1) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Creates a SSL context with a self-signed certificate.
+ *
+ * @param pkey Private key, freed on error
+ *
+ * @return SSL context pointer or NULL if an error occurs
+ */
+static t_ssl_ctx *rinoo_ssl_context_selfsigned(EVP_PKEY *pkey)
 {
-	RSA *rsa;
 	X509 *x509;
 	SSL_CTX *ctx;
-	EVP_PKEY *pkey;
 	X509_NAME *name;
 	t_ssl_ctx *ssl;
 
-	/* SSL_library_init is not reentrant! */
-	SSL_library_init();
-	pkey = EVP_PKEY_new();
-	if (pkey == NULL) {
-		return NULL;
-	}
 	x509 = X509_new();
 	if (x509 == NULL) {
 		EVP_PKEY_free(pkey);
 		return NULL;
 	}
-	rsa = RSA_generate_key(512, RSA_F4, NULL,NULL);
-	if (rsa == NULL || EVP_PKEY_assign_RSA(pkey, rsa) == 0) {
-		X509_free(x509);
-		EVP_PKEY_free(pkey);
-		return NULL;
-	}
 	X509_set_version(x509, 3);
 	ASN1_INTEGER_set(X509_get_serialNumber(x509), 0);
 	X509_gmtime_adj(X509_get_notBefore(x509), 0);
@@ -63,27 +182,25 @@ t_ssl_ctx *rinoo_ssl_context(void)
 		return NULL;
 	}
 	X509_set_issuer_name(x509, name);
-	if (X509_sign(x509, pkey, EVP_md5()) == 0) {
+	if (X509_sign(x509, pkey, EVP_sha256()) == 0) {
 		X509_free(x509);
 		EVP_PKEY_free(pkey);
 		return NULL;
 	}
-	ssl = malloc(sizeof(*ssl));
-	if (ssl == NULL) {
+	ctx = SSL_CTX_new(SSLv23_method());
+	if (ctx == NULL) {
 		X509_free(x509);
 		EVP_PKEY_free(pkey);
 		return NULL;
 	}
-	ctx = SSL_CTX_new(SSLv23_method());
-	if (ctx == NULL) {
+	ssl = rinoo_ssl_context_new(ctx);
+	if (ssl == NULL) {
 		X509_free(x509);
 		EVP_PKEY_free(pkey);
-		free(ssl);
 		return NULL;
 	}
 	ssl->x509 = x509;
 	ssl->pkey = pkey;
-	ssl->ctx = ctx;
 	if (SSL_CTX_use_certificate(ctx, x509) == 0) {
 		rinoo_ssl_context_destroy(ssl);
 		return NULL;
@@ -95,19 +212,661 @@ t_ssl_ctx *rinoo_ssl_context(void)
 	return ssl;
 }
 
+/**
+ * Creates a simple SSL context.
+ *
+ *
+ * @return SSL context pointer
+ */
+t_ssl_ctx *rinoo_ssl_context(void)
+{
+	RSA *rsa;
+	EVP_PKEY *pkey;
+
+	/* SSL_library_init is not reentrant! */
+	SSL_library_init();
+	pkey = EVP_PKEY_new();
+	if (pkey == NULL) {
+		return NULL;
+	}
+	rsa = RSA_generate_key(2048, RSA_F4, NULL,NULL);
+	if (rsa == NULL || EVP_PKEY_assign_RSA(pkey, rsa) == 0) {
+		EVP_PKEY_free(pkey);
+		return NULL;
+	}
+	return rinoo_ssl_context_selfsigned(pkey);
+}
+
+/**
+ * Creates a SSL context with a self-signed ECDSA P-256 certificate.
+ * Signing with P-256 is much cheaper than RSA, which makes handshakes faster.
+ * The context accepts TLS 1.2 and later with X25519 and P-256 key exchanges.
+ *
+ *
+ * @return SSL context pointer or NULL if an error occurs
+ */
+t_ssl_ctx *rinoo_ssl_context_ecdsa(void)
+{
+	EVP_PKEY *pkey;
+	t_ssl_ctx *ssl;
+	EVP_PKEY_CTX *pctx;
+
+	SSL_library_init();
+	pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+	if (pctx == NULL) {
+		return NULL;
+	}
+	pkey = NULL;
+	if (EVP_PKEY_keygen_init(pctx) != 1 ||
+	    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1) != 1 ||
+	    EVP_PKEY_keygen(pctx, &pkey) != 1) {
+		EVP_PKEY_CTX_free(pctx);
+		return NULL;
+	}
+	EVP_PKEY_CTX_free(pctx);
+	ssl = rinoo_ssl_context_selfsigned(pkey);
+	if (ssl == NULL) {
+		return NULL;
+	}
+	if (rinoo_ssl_context_options(ssl->ctx, NULL) != 0) {
+		rinoo_ssl_context_destroy(ssl);
+		return NULL;
+	}
+	return ssl;
+}
+
+/**
+ * Creates a SSL context from PEM certificate and private key files.
+ * RSA and ECDSA keys are supported. Contexts are cached: loading the
+ * same unmodified files with the same options returns the same context,
+ * which must be released with rinoo_ssl_context_destroy by every caller.
+ * Setters (ktls, offload, membio, session cache and tickets) fail with
+ * EBUSY on a shared context, otherwise they take it out of the cache.
+ *
+ * @param cert Certificate chain file
+ * @param key Private key file
+ * @param options Protocol and cipher options, NULL for defaults
+ *
+ * @return SSL context pointer or NULL if an error occurs
+ */
+t_ssl_ctx *rinoo_ssl_context_from_files(const char *cert, const char *key, const t_ssl_options *options)
+{
+	int ret;
+	char *id;
+	SSL_CTX *ctx;
+	t_ssl_ctx *ssl;
+	t_ssl_ctx lookup;
+	t_htable_node *node;
+	struct stat cert_stat;
+	struct stat key_stat;
+
+	XASSERT(cert != NULL, NULL);
+	XASSERT(key != NULL, NULL);
+
+	if (stat(cert, &cert_stat) != 0 || stat(key, &key_stat) != 0) {
+		return NULL;
+	}
+	ret = asprintf(&id, "%s:%lu:%ld:%ld.%09ld:%s:%lu:%ld:%ld.%09ld:%d:%s:%s:%s",
+		       cert, (unsigned long) cert_stat.st_ino, (long) cert_stat.st_size,
+		       (long) cert_stat.st_mtim.tv_sec, (long) cert_stat.st_mtim.tv_nsec,
+		       key, (unsigned long) key_stat.st_ino, (long) key_stat.st_size,
+		       (long) key_stat.st_mtim.tv_sec, (long) key_stat.st_mtim.tv_nsec,
+		       (options != NULL && options->tls13_only),
+		       (options != NULL && options->ciphers != NULL ? options->ciphers : ""),
+		       (options != NULL && options->ciphersuites != NULL ? options->ciphersuites : ""),
+		       (options != NULL && options->groups != NULL ? options->groups : ""));
+	if (ret < 0) {
+		return NULL;
+	}
+	pthread_mutex_lock(&contexts_mutex);
+	if (contexts.table == NULL && htable(&contexts, RINOO_SSL_CONTEXTS_HTABLE_SIZE, rinoo_ssl_context_hash, rinoo_ssl_context_cmp) != 0) {
+		pthread_mutex_unlock(&contexts_mutex);
+		free(id);
+		return NULL;
+	}
+	lookup.id = id;
+	node = htable_get(&contexts, &lookup.node);
+	if (node != NULL) {
+		ssl = container_of(node, t_ssl_ctx, node);
+		ssl->refs++;
+		pthread_mutex_unlock(&contexts_mutex);
+		free(id);
+		return ssl;
+	}
+	SSL_library_init();
+	ctx = SSL_CTX_new(SSLv23_method());
+	if (ctx == NULL) {
+		pthread_mutex_unlock(&contexts_mutex);
+		free(id);
+		return NULL;
+	}
+	if (SSL_CTX_use_certificate_chain_file(ctx, cert) != 1 ||
+	    SSL_CTX_use_PrivateKey_file(ctx, key, SSL_FILETYPE_PEM) != 1 ||
+	    SSL_CTX_check_private_key(ctx) != 1 ||
+	    rinoo_ssl_context_options(ctx, options) != 0) {
+		pthread_mutex_unlock(&contexts_mutex);
+		SSL_CTX_free(ctx);
+		free(id);
+		return NULL;
+	}
+	ssl = rinoo_ssl_context_new(ctx);
+	if (ssl == NULL) {
+		pthread_mutex_unlock(&contexts_mutex);
+		free(id);
+		return NULL;
+	}
+	ssl->id = id;
+	htable_put(&contexts, &ssl->node);
+	pthread_mutex_unlock(&contexts_mutex);
+	return ssl;
+}
+
 /**
  * Destroys a SSL context.
+ * Contexts loaded from files are destroyed once every caller released them.
  *
  * @param ctx SSL contextt pointer
  */
 void rinoo_ssl_context_destroy(t_ssl_ctx *ctx)
 {
-	if (ctx != NULL) {
-		X509_free(ctx->x509);
-		EVP_PKEY_free(ctx->pkey);
-		SSL_CTX_free(ctx->ctx);
-		free(ctx);
+	if (ctx == NULL) {
+		return;
+	}
+	if (ctx->id != NULL) {
+		pthread_mutex_lock(&contexts_mutex);
+		if (--ctx->refs > 0) {
+			pthread_mutex_unlock(&contexts_mutex);
+			return;
+		}
+		htable_remove(&contexts, &ctx->node);
+		pthread_mutex_unlock(&contexts_mutex);
+		free(ctx->id);
 	}
+	if (ctx->sessions_max > 0) {
+		htable_flush(&ctx->sessions, rinoo_ssl_session_free);
+		htable_destroy(&ctx->sessions);
+	}
+	if (ctx->offload != NULL) {
+		rinoo_ssl_offload_destroy(ctx->offload);
+	}
+	pthread_mutex_destroy(&ctx->mutex);
+	X509_free(ctx->x509);
+	EVP_PKEY_free(ctx->pkey);
+	SSL_CTX_free(ctx->ctx);
+	free(ctx);
+}
+
+/**
+ * Enables kernel TLS offload on connections using a SSL context.
+ * After the handshake, OpenSSL installs the session keys on the socket
+ * with setsockopt(SOL_TLS), then write, writev and sendfile are encrypted
+ * by the kernel. Connections silently keep userspace encryption when the
+ * kernel or the negotiated cipher does not support it.
+ *
+ * @param ctx SSL context pointer
+ * @param enabled Whether to enable kernel TLS
+ *
+ * @return 0 on success or -1 if OpenSSL is older than 3.0 or was built without kernel TLS support
+ */
+int rinoo_ssl_context_ktls(t_ssl_ctx *ctx, bool enabled)
+{
+	XASSERT(ctx != NULL, -1);
+
+	if (rinoo_ssl_context_detach(ctx) != 0) {
+		return -1;
+	}
+
+#ifdef RINOO_SSL_KTLS
+	if (enabled) {
+		SSL_CTX_set_options(ctx->ctx, SSL_OP_ENABLE_KTLS);
+	} else {
+		SSL_CTX_clear_options(ctx->ctx, SSL_OP_ENABLE_KTLS);
+	}
+#else
+	if (enabled) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+#endif /* !RINOO_SSL_KTLS */
+	return 0;
+}
+
+/**
+ * Runs handshakes of a SSL context on worker threads.
+ * Tasks doing a handshake are parked while workers perform the
+ * cryptographic operations, so that established connections of the
+ * scheduler are not stalled by bursts of new clients.
+ * Must be called before the context is used.
+ *
+ * @param ctx SSL context pointer
+ * @param threads Number of worker threads, 0 to handshake inline
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_ssl_context_offload(t_ssl_ctx *ctx, int threads)
+{
+	XASSERT(ctx != NULL, -1);
+	XASSERT(threads >= 0, -1);
+
+	if (rinoo_ssl_context_detach(ctx) != 0) {
+		return -1;
+	}
+
+	if (ctx->offload != NULL) {
+		rinoo_ssl_offload_destroy(ctx->offload);
+		ctx->offload = NULL;
+	}
+	if (threads == 0) {
+		return 0;
+	}
+	ctx->offload = rinoo_ssl_offload(threads);
+	if (ctx->offload == NULL) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Makes SSL sockets of a context do their I/O through memory BIOs.
+ * Encrypted data goes through a ring buffer per direction: input is read
+ * from the socket in large chunks rather than record by record. OpenSSL
+ * record buffers are released while a connection waits for input, ring
+ * buffers once it stayed idle for RINOO_SSL_MEMBIO_IDLE milliseconds.
+ * Kernel TLS is not used in this mode.
+ *
+ * @param ctx SSL context pointer
+ * @param size Ring buffer size per direction, 0 to use socket BIOs
+ *
+ * @return 0 on success or -1 if size cannot hold a full record
+ */
+int rinoo_ssl_context_membio(t_ssl_ctx *ctx, size_t size)
+{
+	XASSERT(ctx != NULL, -1);
+
+	if (rinoo_ssl_context_detach(ctx) != 0) {
+		return -1;
+	}
+
+	if (size > 0 && size < SSL3_RT_MAX_PACKET_SIZE) {
+		errno = EINVAL;
+		return -1;
+	}
+	ctx->membio = size;
+	if (size > 0) {
+		SSL_CTX_set_mode(ctx->ctx, SSL_MODE_RELEASE_BUFFERS);
+	} else {
+		SSL_CTX_clear_mode(ctx->ctx, SSL_MODE_RELEASE_BUFFERS);
+	}
+	return 0;
+}
+
+/**
+ * Tells whether a SSL socket sends through kernel TLS.
+ *
+ * @param socket Socket pointer
+ *
+ * @return true if records are encrypted by the kernel, otherwise false
+ */
+bool rinoo_ssl_ktls(t_socket *socket)
+{
+	XASSERT(socket != NULL, false);
+
+	return rinoo_ssl_get(socket)->ktls_send;
+}
+
+/**
+ * Checks whether an idle SSL connection is still usable, without blocking.
+ * Records received meanwhile are processed: post-handshake messages are
+ * fine, whereas a close_notify alert, end of file or application data
+ * make the connection unusable.
+ *
+ * @param socket Socket pointer
+ *
+ * @return 0 if the connection can be used, otherwise -1
+ */
+int rinoo_ssl_check(t_socket *socket)
+{
+	int ret;
+	int len;
+	char c;
+	char *ptr;
+	t_ssl *ssl;
+
+	XASSERT(socket != NULL, -1);
+
+	ssl = rinoo_ssl_get(socket);
+	if (ssl->network != NULL && (len = BIO_nwrite0(ssl->network, &ptr)) > 0) {
+		/* Memory BIOs: takes what the socket holds */
+		ret = read(socket->node.fd, ptr, len);
+		if (ret == 0 || (ret < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+			return -1;
+		}
+		if (ret > 0) {
+			BIO_nwrite(ssl->network, &ptr, ret);
+		}
+	}
+	ERR_clear_error();
+	ret = SSL_peek(ssl->ssl, &c, 1);
+	if (ret > 0) {
+		return -1;
+	}
+	ret = SSL_get_error(ssl->ssl, ret);
+	ERR_clear_error();
+	errno = 0;
+	return (ret == SSL_ERROR_WANT_READ ? 0 : -1);
+}
+
+/**
+ * Stores a client session received from a server.
+ * Only the last session per destination is kept.
+ *
+ * @param ssl OpenSSL connection pointer
+ * @param sess New session
+ *
+ * @return 1 if the session reference is kept, otherwise 0
+ */
+static int rinoo_ssl_session_new(SSL *ssl, SSL_SESSION *sess)
+{
+	t_ssl *rssl;
+	t_ssl_ctx *ctx;
+	t_ssl_session key;
+	t_ssl_session *session;
+	t_htable_node *node;
+
+	rssl = SSL_get_app_data(ssl);
+	if (SSL_is_server(ssl) || rssl == NULL) {
+		return 0;
+	}
+	ctx = rssl->ctx;
+	key.peer = rssl->peer;
+	pthread_mutex_lock(&ctx->mutex);
+	node = htable_get(&ctx->sessions, &key.node);
+	if (node != NULL) {
+		session = container_of(node, t_ssl_session, node);
+		SSL_SESSION_free(session->session);
+		session->session = sess;
+		pthread_mutex_unlock(&ctx->mutex);
+		return 1;
+	}
+	if (htable_size(&ctx->sessions) >= ctx->sessions_max) {
+		pthread_mutex_unlock(&ctx->mutex);
+		return 0;
+	}
+	session = malloc(sizeof(*session));
+	if (session == NULL) {
+		pthread_mutex_unlock(&ctx->mutex);
+		return 0;
+	}
+	session->peer = rssl->peer;
+	session->session = sess;
+	htable_put(&ctx->sessions, &session->node);
+	pthread_mutex_unlock(&ctx->mutex);
+	return 1;
+}
+
+/**
+ * Resumes the last session used with the destination of a client socket.
+ *
+ * @param socket Socket pointer
+ * @param addr Destination address
+ * @param addrlen Destination address size
+ */
+void rinoo_ssl_session_resume(t_socket *socket, const struct sockaddr *addr, socklen_t addrlen)
+{
+	t_ssl *ssl;
+	t_ssl_ctx *ctx;
+	t_ssl_session key;
+	t_htable_node *node;
+
+	ssl = rinoo_ssl_get(socket);
+	ctx = ssl->ctx;
+	SSL_set_app_data(ssl->ssl, ssl);
+	if (ctx->sessions_max == 0) {
+		return;
+	}
+	/* Only significant fields make the key, sin_zero may contain garbage */
+	memset(&ssl->peer, 0, sizeof(ssl->peer));
+	if (addr->sa_family == AF_INET && addrlen >= sizeof(ssl->peer.v4)) {
+		ssl->peer.v4.sin_family = AF_INET;
+		ssl->peer.v4.sin_port = ((struct sockaddr_in *) addr)->sin_port;
+		ssl->peer.v4.sin_addr = ((struct sockaddr_in *) addr)->sin_addr;
+	} else if (addr->sa_family == AF_INET6 && addrlen >= sizeof(ssl->peer.v6)) {
+		ssl->peer.v6.sin6_family = AF_INET6;
+		ssl->peer.v6.sin6_port = ((struct sockaddr_in6 *) addr)->sin6_port;
+		ssl->peer.v6.sin6_addr = ((struct sockaddr_in6 *) addr)->sin6_addr;
+		ssl->peer.v6.sin6_scope_id = ((struct sockaddr_in6 *) addr)->sin6_scope_id;
+	}
+	key.peer = ssl->peer;
+	pthread_mutex_lock(&ctx->mutex);
+	node = htable_get(&ctx->sessions, &key.node);
+	if (node != NULL) {
+		SSL_set_session(ssl->ssl, container_of(node, t_ssl_session, node)->session);
+	}
+	pthread_mutex_unlock(&ctx->mutex);
+}
+
+/**
+ * Updates session counters once a handshake is done.
+ *
+ * @param socket Socket pointer
+ */
+void rinoo_ssl_session_count(t_socket *socket)
+{
+	t_ssl *ssl = rinoo_ssl_get(socket);
+	t_ssl_session_stats *stats = &ssl->ctx->stats;
+
+	if (SSL_is_server(ssl->ssl)) {
+		__atomic_add_fetch((SSL_session_reused(ssl->ssl) ? &stats->hits : &stats->misses), 1, __ATOMIC_RELAXED);
+	} else {
+		__atomic_add_fetch((SSL_session_reused(ssl->ssl) ? &stats->resumed : &stats->full), 1, __ATOMIC_RELAXED);
+	}
+}
+
+/**
+ * Enables session caching on a SSL context.
+ * Servers keep sessions in the OpenSSL cache of the context, which is
+ * locked internally and thus shared by every spawn using the context.
+ * Clients keep the last session per destination and try to resume it
+ * in rinoo_ssl_client.
+ *
+ * @param ctx SSL context pointer
+ * @param size Maximum number of sessions kept on each side
+ * @param timeout Session lifetime in seconds, 0 for OpenSSL default
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_ssl_context_session_cache(t_ssl_ctx *ctx, uint32_t size, uint32_t timeout)
+{
+	XASSERT(ctx != NULL, -1);
+	XASSERT(size > 0, -1);
+
+	if (rinoo_ssl_context_detach(ctx) != 0) {
+		return -1;
+	}
+
+	if (ctx->sessions_max == 0) {
+		if (htable(&ctx->sessions, RINOO_SSL_SESSIONS_HTABLE_SIZE, rinoo_ssl_session_hash, rinoo_ssl_session_cmp) != 0) {
+			return -1;
+		}
+	}
+	ctx->sessions_max = size;
+	SSL_CTX_set_session_cache_mode(ctx->ctx, SSL_SESS_CACHE_BOTH);
+	SSL_CTX_set_session_id_context(ctx->ctx, (const unsigned char *) "rinoo", 5);
+	SSL_CTX_sess_set_cache_size(ctx->ctx, size);
+	SSL_CTX_sess_set_new_cb(ctx->ctx, rinoo_ssl_session_new);
+	if (timeout != 0) {
+		SSL_CTX_set_timeout(ctx->ctx, timeout);
+	}
+	return 0;
+}
+
+/**
+ * Generates a new ticket key.
+ *
+ * @param key Ticket key to fill
+ * @param now Current time
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_ssl_ticket_key(t_ssl_ticket_key *key, time_t now)
+{
+	if (RAND_bytes(key->name, sizeof(key->name)) != 1 ||
+	    RAND_bytes(key->aes, sizeof(key->aes)) != 1 ||
+	    RAND_bytes(key->hmac, sizeof(key->hmac)) != 1) {
+		return -1;
+	}
+	key->created = now;
+	return 0;
+}
+
+/**
+ * Rotates ticket keys. Must be called with the context locked.
+ * The previous key still decrypts tickets for one more period.
+ *
+ * @param ctx SSL context pointer
+ */
+static void rinoo_ssl_ticket_rotate(t_ssl_ctx *ctx)
+{
+	time_t now;
+	t_ssl_ticket_key key;
+
+	now = time(NULL);
+	if (now - ctx->keys[0].created < ctx->rotation) {
+		return;
+	}
+	if (rinoo_ssl_ticket_key(&key, now) != 0) {
+		/* Keep the current key rather than failing handshakes */
+		return;
+	}
+	if (now - ctx->keys[0].created < 2 * ctx->rotation) {
+		ctx->keys[1] = ctx->keys[0];
+	} else {
+		ctx->keys[1].created = 0;
+	}
+	ctx->keys[0] = key;
+}
+
+/**
+ * Ticket key callback, see SSL_CTX_set_tlsext_ticket_key_evp_cb.
+ *
+ * @return 1 when encrypting, 2 to accept and renew a ticket, 0 if the key is unknown or -1 on error
+ */
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+static int rinoo_ssl_ticket_cb(SSL *ssl, unsigned char *name, unsigned char *iv, EVP_CIPHER_CTX *cctx, EVP_MAC_CTX *hctx, int enc)
+#else
+static int rinoo_ssl_ticket_cb(SSL *ssl, unsigned char *name, unsigned char *iv, EVP_CIPHER_CTX *cctx, HMAC_CTX *hctx, int enc)
+#endif
+{
+	int ret;
+	t_ssl_ctx *ctx;
+	t_ssl_ticket_key key;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	OSSL_PARAM params[2];
+#endif
+
+	ctx = SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl));
+	pthread_mutex_lock(&ctx->mutex);
+	rinoo_ssl_ticket_rotate(ctx);
+	/*
+	 * Accepted tickets are always renewed: TLS 1.3 clients use a ticket
+	 * once, and a ticket from the previous key must move to the current one.
+	 */
+	if (enc) {
+		key = ctx->keys[0];
+		ret = 1;
+	} else if (memcmp(name, ctx->keys[0].name, sizeof(key.name)) == 0) {
+		key = ctx->keys[0];
+		ret = 2;
+	} else if (ctx->keys[1].created != 0 && memcmp(name, ctx->keys[1].name, sizeof(key.name)) == 0) {
+		key = ctx->keys[1];
+		ret = 2;
+	} else {
+		ret = 0;
+	}
+	pthread_mutex_unlock(&ctx->mutex);
+	if (ret == 0) {
+		return 0;
+	}
+	if (enc) {
+		memcpy(name, key.name, sizeof(key.name));
+		if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1 ||
+		    EVP_EncryptInit_ex(cctx, EVP_aes_256_cbc(), NULL, key.aes, iv) != 1) {
+			return -1;
+		}
+	} else if (EVP_DecryptInit_ex(cctx, EVP_aes_256_cbc(), NULL, key.aes, iv) != 1) {
+		return -1;
+	}
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, "SHA256", 0);
+	params[1] = OSSL_PARAM_construct_end();
+	if (EVP_MAC_init(hctx, key.hmac, sizeof(key.hmac), params) != 1) {
+		return -1;
+	}
+#else
+	if (HMAC_Init_ex(hctx, key.hmac, sizeof(key.hmac), EVP_sha256(), NULL) != 1) {
+		return -1;
+	}
+#endif
+	return ret;
+}
+
+/**
+ * Enables session tickets with rotating keys on a SSL context.
+ * Keys are shared by every spawn using the context, a ticket stays
+ * valid between one and two rotation periods and gets renewed each
+ * time it is used.
+ *
+ * @param ctx SSL context pointer
+ * @param rotation Key rotation period in seconds, 0 to disable tickets
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_ssl_context_tickets(t_ssl_ctx *ctx, uint32_t rotation)
+{
+	int ret;
+
+	XASSERT(ctx != NULL, -1);
+
+	if (rinoo_ssl_context_detach(ctx) != 0) {
+		return -1;
+	}
+
+	if (rotation == 0) {
+		SSL_CTX_set_options(ctx->ctx, SSL_OP_NO_TICKET);
+		return 0;
+	}
+	pthread_mutex_lock(&ctx->mutex);
+	ctx->rotation = rotation;
+	ctx->keys[1].created = 0;
+	ret = rinoo_ssl_ticket_key(&ctx->keys[0], time(NULL));
+	pthread_mutex_unlock(&ctx->mutex);
+	if (ret != 0) {
+		return -1;
+	}
+	SSL_CTX_clear_options(ctx->ctx, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx->ctx, rinoo_ssl_ticket_cb);
+#else
+	SSL_CTX_set_tlsext_ticket_key_cb(ctx->ctx, rinoo_ssl_ticket_cb);
+#endif
+	return 0;
+}
+
+/**
+ * Gets session counters of a SSL context.
+ *
+ * @param ctx SSL context pointer
+ * @param stats Pointer where to store counters
+ */
+void rinoo_ssl_context_stats(t_ssl_ctx *ctx, t_ssl_session_stats *stats)
+{
+	XASSERTN(ctx != NULL);
+	XASSERTN(stats != NULL);
+
+	stats->hits = __atomic_load_n(&ctx->stats.hits, __ATOMIC_RELAXED);
+	stats->misses = __atomic_load_n(&ctx->stats.misses, __ATOMIC_RELAXED);
+	stats->resumed = __atomic_load_n(&ctx->stats.resumed, __ATOMIC_RELAXED);
+	stats->full = __atomic_load_n(&ctx->stats.full, __ATOMIC_RELAXED);
 }
 
 /**
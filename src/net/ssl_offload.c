@@ -0,0 +1,228 @@
+/**
+ * @file   ssl_offload.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Mon Oct 19 00:24:37 2026
+ *
+ * @brief  TLS handshake offloading to worker threads
+ *
+ *
+ */
+
+#include "rinoo/net/module.h"
+
+/**
+ * Worker thread main loop.
+ * OpenSSL errors are per thread, so the step result is computed here.
+ *
+ * @param arg Offload pool pointer
+ *
+ * @return NULL
+ */
+static void *rinoo_ssl_offload_worker(void *arg)
+{
+	t_list_node *node;
+	t_ssl_offload_job *job;
+	t_ssl_offload *offload = arg;
+
+	pthread_mutex_lock(&offload->mutex);
+	while (!offload->stop) {
+		/* Jobs are put at the head, the oldest one is the tail */
+		node = offload->jobs.tail;
+		if (node == NULL) {
+			pthread_cond_wait(&offload->cond, &offload->mutex);
+			continue;
+		}
+		list_remove(&offload->jobs, node);
+		offload->steps++;
+		pthread_mutex_unlock(&offload->mutex);
+		job = container_of(node, t_ssl_offload_job, lnode);
+		ERR_clear_error();
+		job->ret = SSL_do_handshake(job->ssl);
+		job->error = SSL_get_error(job->ssl, job->ret);
+		ERR_clear_error();
+		eventfd_write(job->node.fd, 1);
+		pthread_mutex_lock(&offload->mutex);
+	}
+	pthread_mutex_unlock(&offload->mutex);
+	return NULL;
+}
+
+/**
+ * Creates a handshake offload pool.
+ *
+ * @param count Number of worker threads
+ *
+ * @return Offload pool pointer or NULL if an error occurs
+ */
+t_ssl_offload *rinoo_ssl_offload(int count)
+{
+	int i;
+	t_ssl_offload *offload;
+
+	XASSERT(count > 0, NULL);
+
+	offload = calloc(1, sizeof(*offload));
+	if (offload == NULL) {
+		return NULL;
+	}
+	offload->threads = calloc(count, sizeof(*offload->threads));
+	if (offload->threads == NULL) {
+		free(offload);
+		return NULL;
+	}
+	list(&offload->jobs, NULL);
+	pthread_mutex_init(&offload->mutex, NULL);
+	pthread_cond_init(&offload->cond, NULL);
+	for (i = 0; i < count; i++) {
+		if (pthread_create(&offload->threads[i], NULL, rinoo_ssl_offload_worker, offload) != 0) {
+			rinoo_ssl_offload_destroy(offload);
+			return NULL;
+		}
+		offload->count++;
+	}
+	return offload;
+}
+
+/**
+ * Stops worker threads and destroys an offload pool.
+ * No handshake must be in progress.
+ *
+ * @param offload Offload pool pointer
+ */
+void rinoo_ssl_offload_destroy(t_ssl_offload *offload)
+{
+	int i;
+
+	XASSERTN(offload != NULL);
+
+	pthread_mutex_lock(&offload->mutex);
+	offload->stop = true;
+	pthread_cond_broadcast(&offload->cond);
+	pthread_mutex_unlock(&offload->mutex);
+	for (i = 0; i < offload->count; i++) {
+		pthread_join(offload->threads[i], NULL);
+	}
+	pthread_cond_destroy(&offload->cond);
+	pthread_mutex_destroy(&offload->mutex);
+	free(offload->threads);
+	free(offload);
+}
+
+/**
+ * Prepares the offloading of a connection handshake.
+ * The job eventfd stays registered in the scheduler between steps.
+ *
+ * @param job Job to initialize
+ * @param sched Scheduler of the connection
+ * @param ssl OpenSSL connection
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_ssl_offload_job(t_ssl_offload_job *job, t_sched *sched, SSL *ssl)
+{
+	XASSERT(job != NULL, -1);
+	XASSERT(sched != NULL, -1);
+	XASSERT(ssl != NULL, -1);
+
+	memset(job, 0, sizeof(*job));
+	job->ssl = ssl;
+	job->node.sched = sched;
+	job->node.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (job->node.fd < 0) {
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Releases an offload job once its handshake is over.
+ *
+ * @param job Job to destroy
+ */
+void rinoo_ssl_offload_job_destroy(t_ssl_offload_job *job)
+{
+	XASSERTN(job != NULL);
+
+	rinoo_sched_remove(&job->node);
+	close(job->node.fd);
+	job->node.fd = -1;
+}
+
+/**
+ * Waits for a worker to finish a step without the scheduler. Only used
+ * when the task cannot be parked anymore (scheduler stopped or
+ * cancelled), while nothing else runs in this scheduler.
+ *
+ * @param job Job to wait for
+ */
+static void rinoo_ssl_offload_sync(t_ssl_offload_job *job)
+{
+	eventfd_t value;
+	struct pollfd pfd;
+
+	pfd.fd = job->node.fd;
+	pfd.events = POLLIN;
+	while (eventfd_read(job->node.fd, &value) != 0) {
+		poll(&pfd, 1, -1);
+	}
+}
+
+/**
+ * Runs one SSL_do_handshake step on a worker thread.
+ * The calling task is parked until the step is done, other tasks keep
+ * running meanwhile. As the worker uses the connection, the task stays
+ * parked past its timeout or deadline, which is reported once the step
+ * is done.
+ *
+ * @param offload Offload pool pointer
+ * @param job Job of the connection, see rinoo_ssl_offload_job
+ * @param error Pointer where to store the SSL_get_error result
+ *
+ * @return SSL_do_handshake result or -1 if the step timed out or failed
+ */
+int rinoo_ssl_offload_handshake(t_ssl_offload *offload, t_ssl_offload_job *job, int *error)
+{
+	int failure;
+	t_task *task;
+	t_sched *sched;
+	uint64_t deadline;
+	eventfd_t value;
+
+	XASSERT(offload != NULL, -1);
+	XASSERT(job != NULL, -1);
+	XASSERT(error != NULL, -1);
+
+	failure = 0;
+	sched = job->node.sched;
+	task = rinoo_task_driver_getcurrent(sched);
+	deadline = task->deadline;
+	pthread_mutex_lock(&offload->mutex);
+	list_put(&offload->jobs, &job->lnode);
+	pthread_cond_signal(&offload->cond);
+	pthread_mutex_unlock(&offload->mutex);
+	while (eventfd_read(job->node.fd, &value) != 0) {
+		if (task == &sched->driver.main && sched->stop) {
+			rinoo_ssl_offload_sync(job);
+			break;
+		}
+		if (rinoo_sched_waitfor(&job->node, RINOO_MODE_IN) == 0) {
+			continue;
+		}
+		failure = errno;
+		if (failure != ETIMEDOUT) {
+			rinoo_ssl_offload_sync(job);
+			break;
+		}
+		/* The worker still uses the connection: stay parked until it is done */
+		task->deadline = 0;
+		rinoo_task_unschedule(task);
+	}
+	task->deadline = deadline;
+	if (failure != 0) {
+		*error = SSL_ERROR_SYSCALL;
+		errno = failure;
+		return -1;
+	}
+	*error = job->error;
+	return job->ret;
+}
@@ -14,17 +14,19 @@ extern const t_socket_class socket_class_tcp;
 extern const t_socket_class socket_class_tcp6;
 
 /**
- * Creates a TCP client to be connected to a specific IP, on a specific port.
+ * Creates a TCP client and connects it.
  *
  * @param sched Scheduler pointer
  * @param ip Destination IP to connect to
  * @param port Destination port to connect to
  * @param timeout Socket timeout
+ * @param fastopen Whether to try TCP Fast Open
  *
  * @return Socket pointer on success or NULL if an error occurs
  */
-t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout)
+static t_socket *rinoo_tcp_client_open(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout, bool fastopen)
 {
+	int enabled;
 	t_ip loopback;
 	t_socket *socket;
 	socklen_t addr_len;
@@ -44,6 +46,17 @@ t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t tim
 		rinoo_socket_destroy(socket);
 		return NULL;
 	}
+	if (fastopen) {
+		/*
+		 * With a cached cookie, connect(2) returns at once and the SYN
+		 * leaves with the first write. Otherwise a regular SYN requesting
+		 * a cookie is sent. Kernels without support use a plain connect.
+		 */
+		enabled = 1;
+		if (setsockopt(socket->node.fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &enabled, sizeof(enabled)) != 0) {
+			errno = 0;
+		}
+	}
 	if (ip->v4.sin_family == AF_INET) {
 		ip->v4.sin_port = htons(port);
 		addr = (struct sockaddr *) &ip->v4;
@@ -60,6 +73,290 @@ t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t tim
 	return socket;
 }
 
+/**
+ * Creates a TCP client to be connected to a specific IP, on a specific port.
+ *
+ * @param sched Scheduler pointer
+ * @param ip Destination IP to connect to
+ * @param port Destination port to connect to
+ * @param timeout Socket timeout
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout)
+{
+	return rinoo_tcp_client_open(sched, ip, port, timeout, false);
+}
+
+/**
+ * Creates a TCP client using TCP Fast Open.
+ * Once the server gave a cookie, the first write is sent along with the
+ * SYN, saving a round trip. The caller must write first: the connection
+ * may not be established before that. Connection errors may then only
+ * be reported by the first read.
+ *
+ * @param sched Scheduler pointer
+ * @param ip Destination IP to connect to
+ * @param port Destination port to connect to
+ * @param timeout Socket timeout
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_tcp_client_fastopen(t_sched *sched, t_ip *ip, uint16_t port, uint32_t timeout)
+{
+	return rinoo_tcp_client_open(sched, ip, port, timeout, true);
+}
+
+/**
+ * Orders addresses for connection attempts, alternating address families
+ * and starting with the family of the first address (RFC 8305).
+ *
+ * @param ips Addresses in preference order
+ * @param n Number of addresses
+ * @param order Array where to store address indexes
+ */
+static void rinoo_tcp_multi_order(t_ip *ips, int n, int *order)
+{
+	int i;
+	int first;
+	int other;
+	bool v6;
+
+	first = 0;
+	other = 0;
+	v6 = IS_IPV6((&ips[0]));
+	for (i = 0; i < n; i++) {
+		if (i % 2 == 0) {
+			while (first < n && IS_IPV6((&ips[first])) != v6) {
+				first++;
+			}
+			if (first < n) {
+				order[i] = first++;
+				continue;
+			}
+		} else {
+			while (other < n && IS_IPV6((&ips[other])) == v6) {
+				other++;
+			}
+			if (other < n) {
+				order[i] = other++;
+				continue;
+			}
+		}
+		/* One family is exhausted, take what remains of the other one */
+		while (first < n && IS_IPV6((&ips[first])) != v6) {
+			first++;
+		}
+		if (first < n) {
+			order[i] = first++;
+		} else {
+			while (other < n && IS_IPV6((&ips[other])) == v6) {
+				other++;
+			}
+			order[i] = other++;
+		}
+	}
+}
+
+/**
+ * Starts a non-blocking connection attempt.
+ *
+ * @param sched Scheduler pointer
+ * @param epfd Attempts epoll descriptor
+ * @param ip Destination
+ * @param port Destination port
+ * @param index Attempt index reported by epoll
+ * @param socket Pointer where to store the socket
+ *
+ * @return 1 if connected, 0 if in progress or -1 if the attempt failed
+ */
+static int rinoo_tcp_multi_attempt(t_sched *sched, int epfd, t_ip *ip, uint16_t port, int index, t_socket **socket)
+{
+	t_ip addr;
+	socklen_t addr_len;
+	struct epoll_event event;
+
+	*socket = rinoo_socket(sched, (IS_IPV6(ip) ? &socket_class_tcp6 : &socket_class_tcp));
+	if (unlikely(*socket == NULL)) {
+		return -1;
+	}
+	addr = *ip;
+	if (IS_IPV6(ip)) {
+		addr.v6.sin6_port = htons(port);
+		addr_len = sizeof(addr.v6);
+	} else {
+		addr.v4.sin_port = htons(port);
+		addr_len = sizeof(addr.v4);
+	}
+	if (connect((*socket)->node.fd, (struct sockaddr *) &addr, addr_len) == 0) {
+		return 1;
+	}
+	if (errno == EINPROGRESS) {
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLOUT;
+		event.data.u32 = index;
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, (*socket)->node.fd, &event) == 0) {
+			return 0;
+		}
+	}
+	rinoo_socket_destroy(*socket);
+	*socket = NULL;
+	return -1;
+}
+
+/**
+ * Creates a TCP client connected to the first reachable address among
+ * several ones, racing staggered connection attempts (happy eyeballs,
+ * RFC 8305). A new attempt starts every RINOO_TCP_ATTEMPT_DELAY ms, or
+ * as soon as every pending one failed. The first established connection
+ * is kept and the other attempts are cancelled.
+ * Must be called from a task.
+ *
+ * @param sched Scheduler pointer
+ * @param ips Destination addresses in preference order
+ * @param n Number of addresses
+ * @param port Destination port
+ * @param timeout Overall connection and socket timeout in ms, 0 for none
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_tcp_client_multi(t_sched *sched, t_ip *ips, int n, uint16_t port, uint32_t timeout)
+{
+	int i;
+	int nb;
+	int ret;
+	int val;
+	int epfd;
+	int next;
+	int error;
+	int pending;
+	int *order;
+	t_task *task;
+	t_socket *winner;
+	t_socket **attempts;
+	socklen_t size;
+	uint64_t wakeup;
+	uint64_t deadline;
+	t_sched_node node;
+	struct epoll_event events[8];
+
+	XASSERT(sched != NULL, NULL);
+	XASSERT(ips != NULL, NULL);
+	XASSERT(n > 0, NULL);
+
+	task = rinoo_task_driver_getcurrent(sched);
+	if (task == &sched->driver.main) {
+		errno = EINVAL;
+		return NULL;
+	}
+	order = malloc(n * sizeof(*order));
+	attempts = calloc(n, sizeof(*attempts));
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (order == NULL || attempts == NULL || epfd < 0) {
+		if (epfd >= 0) {
+			close(epfd);
+		}
+		free(attempts);
+		free(order);
+		return NULL;
+	}
+	rinoo_tcp_multi_order(ips, n, order);
+	memset(&node, 0, sizeof(node));
+	node.fd = epfd;
+	node.sched = sched;
+	deadline = 0;
+	if (timeout != 0) {
+		deadline = sched->clock + timeout * RINOO_NSEC_PER_MSEC;
+		if (task->deadline != 0 && task->deadline < deadline) {
+			deadline = task->deadline;
+		}
+	}
+	winner = NULL;
+	error = ETIMEDOUT;
+	next = 0;
+	wakeup = 0;
+	pending = 0;
+	while (winner == NULL) {
+		if (pending == 0 || (next < n && sched->clock >= wakeup)) {
+			/* Start the next attempt, failed ones are replaced at once */
+			while (next < n) {
+				i = order[next++];
+				ret = rinoo_tcp_multi_attempt(sched, epfd, &ips[i], port, i, &attempts[i]);
+				if (ret == 1) {
+					winner = attempts[i];
+					attempts[i] = NULL;
+					break;
+				}
+				if (ret == 0) {
+					pending++;
+					break;
+				}
+				error = errno;
+			}
+			if (winner != NULL) {
+				break;
+			}
+			if (pending == 0) {
+				break;
+			}
+			wakeup = sched->clock + RINOO_TCP_ATTEMPT_DELAY * RINOO_NSEC_PER_MSEC;
+		}
+		if (next < n && (deadline == 0 || wakeup < deadline)) {
+			rinoo_task_schedule_ns(task, wakeup);
+		} else if (deadline != 0) {
+			rinoo_task_schedule_ns(task, deadline);
+		} else {
+			rinoo_task_unschedule(task);
+		}
+		if (rinoo_sched_waitfor(&node, RINOO_MODE_IN) != 0) {
+			if (errno != ETIMEDOUT || (deadline != 0 && sched->clock >= deadline)) {
+				error = errno;
+				break;
+			}
+			continue;
+		}
+		while ((nb = epoll_wait(epfd, events, sizeof(events) / sizeof(*events), 0)) > 0) {
+			for (i = 0; i < nb && winner == NULL; i++) {
+				t_socket **attempt = &attempts[events[i].data.u32];
+
+				size = sizeof(val);
+				if (getsockopt((*attempt)->node.fd, SOL_SOCKET, SO_ERROR, &val, &size) == 0 && val == 0) {
+					winner = *attempt;
+					*attempt = NULL;
+					break;
+				}
+				error = (val != 0 ? val : errno);
+				epoll_ctl(epfd, EPOLL_CTL_DEL, (*attempt)->node.fd, NULL);
+				rinoo_socket_destroy(*attempt);
+				*attempt = NULL;
+				pending--;
+			}
+			if (winner != NULL) {
+				break;
+			}
+		}
+	}
+	rinoo_sched_remove(&node);
+	close(epfd);
+	for (i = 0; i < n; i++) {
+		if (attempts[i] != NULL) {
+			rinoo_socket_destroy(attempts[i]);
+		}
+	}
+	free(attempts);
+	free(order);
+	/* Like rinoo_tcp_client, the timeout keeps applying to the socket */
+	if (deadline != 0) {
+		rinoo_task_schedule_ns(task, deadline);
+	} else {
+		rinoo_task_unschedule(task);
+	}
+	if (winner == NULL) {
+		errno = error;
+	}
+	return winner;
+}
+
 /**
  * Creates a TCP server listening to a specific port, on a specific IP.
  *
@@ -71,6 +368,24 @@ t_socket *rinoo_tcp_client(t_sched *sched, t_ip *ip, uint16_t port, uint32_t tim
  */
 t_socket *rinoo_tcp_server(t_sched *sched, t_ip *ip, uint16_t port)
 {
+	return rinoo_tcp_server_options(sched, ip, port, NULL);
+}
+
+/**
+ * Creates a TCP server listening to a specific port, on a specific IP,
+ * with listener options.
+ *
+ * @param sched Scheduler pointer
+ * @param ip IP to bind
+ * @param port Port to bind
+ * @param options Listener options, NULL for defaults
+ *
+ * @return Socket pointer to the server on success or NULL if an error occurs
+ */
+t_socket *rinoo_tcp_server_options(t_sched *sched, t_ip *ip, uint16_t port, const t_tcp_listen_options *options)
+{
+	int backlog;
+	int defer;
 	t_ip any;
 	t_socket *socket;
 	socklen_t addr_len;
@@ -95,7 +410,26 @@ t_socket *rinoo_tcp_server(t_sched *sched, t_ip *ip, uint16_t port)
 		addr = (struct sockaddr *) &ip->v6;
 		addr_len = sizeof(ip->v6);
 	}
-	if (rinoo_socket_bind(socket, addr, addr_len, RINOO_TCP_BACKLOG) != 0) {
+	backlog = RINOO_TCP_BACKLOG;
+	if (options != NULL && options->backlog > 0) {
+		backlog = options->backlog;
+	}
+	if (options != NULL && options->defer_accept > 0) {
+		/* Connections are only reported once data arrived */
+		defer = options->defer_accept;
+		if (setsockopt(socket->node.fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &defer, sizeof(defer)) != 0) {
+			rinoo_socket_destroy(socket);
+			return NULL;
+		}
+	}
+	if (options != NULL && options->fastopen > 0) {
+		/* Length of the queue of connections carrying data in their SYN */
+		if (setsockopt(socket->node.fd, IPPROTO_TCP, TCP_FASTOPEN, &options->fastopen, sizeof(options->fastopen)) != 0) {
+			rinoo_socket_destroy(socket);
+			return NULL;
+		}
+	}
+	if (rinoo_socket_bind(socket, addr, addr_len, backlog) != 0) {
 		rinoo_socket_destroy(socket);
 		return NULL;
 	}
@@ -131,3 +465,241 @@ t_socket *rinoo_tcp_accept(t_socket *socket, t_ip *fromip, uint16_t *fromport)
 	}
 	return new;
 }
+
+/**
+ * Accepts a batch of connections from a listening socket.
+ * Pending connections are drained until none is left or count is reached,
+ * the calling task only waits when no connection is pending.
+ *
+ * @param socket Pointer to the socket which is listening to
+ * @param clients Array where to store accepted sockets
+ * @param count Array size
+ *
+ * @return The number of accepted sockets on success or -1 if an error occurs
+ */
+int rinoo_tcp_accept_many(t_socket *socket, t_socket **clients, int count)
+{
+	XASSERT(socket != NULL, -1);
+	XASSERT(clients != NULL, -1);
+	XASSERT(count > 0, -1);
+	XASSERT(socket->class->accept == rinoo_socket_class_tcp_accept, -1);
+
+	return rinoo_socket_class_tcp_accept_many(socket, clients, count);
+}
+
+/**
+ * Pins the calling thread to the CPU matching a listener index.
+ *
+ * @param listener Listener whose scheduler runs in the calling thread
+ */
+static void rinoo_tcp_spawned_pin(t_tcp_spawned_listener *listener)
+{
+	long nbcpus;
+	cpu_set_t cpus;
+
+	nbcpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nbcpus <= 0) {
+		return;
+	}
+	CPU_ZERO(&cpus);
+	CPU_SET(listener->id % nbcpus, &cpus);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+		rinoo_log("Scheduler %d: could not be pinned to a CPU", listener->id);
+	}
+}
+
+/**
+ * Accept loop of a spawned server listener. Each accepted connection
+ * is handled by a new task on the listener scheduler.
+ *
+ * @param arg Pointer to the listener
+ */
+static void rinoo_tcp_spawned_accept(void *arg)
+{
+	int i;
+	int nbclients;
+	t_tcp_spawned_listener *listener = arg;
+	t_socket *clients[RINOO_TCP_ACCEPT_BATCH];
+
+	if (listener->server->steering) {
+		rinoo_tcp_spawned_pin(listener);
+	}
+	while ((nbclients = rinoo_tcp_accept_many(listener->socket, clients, RINOO_TCP_ACCEPT_BATCH)) > 0) {
+		listener->accepted += nbclients;
+		for (i = 0; i < nbclients; i++) {
+			if (rinoo_task_start(listener->sched, listener->server->handler, clients[i]) != 0) {
+				rinoo_socket_destroy(clients[i]);
+			}
+		}
+	}
+	rinoo_socket_destroy(listener->socket);
+	listener->socket = NULL;
+}
+
+/**
+ * Creates a TCP server listening on every scheduler: sched itself and
+ * each of its spawns get their own SO_REUSEPORT listener, so the kernel
+ * spreads connections across threads without a shared accept queue.
+ * handler runs in a new task, on the accepting scheduler, for every
+ * connection and owns the client socket.
+ * Spawns must be created before and this must be called before running
+ * the main scheduler loop.
+ *
+ * @param sched Main scheduler
+ * @param ip IP to bind
+ * @param port Port to bind
+ * @param handler Task function handling one client socket
+ *
+ * @return Pointer to the server on success or NULL if an error occurs
+ */
+t_tcp_spawned *rinoo_tcp_server_spawned(t_sched *sched, t_ip *ip, uint16_t port, void (*handler)(void *socket))
+{
+	int i;
+	t_ip addr;
+	t_task **tasks;
+	t_tcp_spawned *server;
+	t_tcp_spawned_listener *listener;
+
+	XASSERT(sched != NULL, NULL);
+	XASSERT(handler != NULL, NULL);
+
+	server = calloc(1, sizeof(*server));
+	if (unlikely(server == NULL)) {
+		return NULL;
+	}
+	server->count = sched->spawns.count + 1;
+	server->handler = handler;
+	server->start = sched->clock;
+	server->listeners = calloc(server->count, sizeof(*server->listeners));
+	tasks = calloc(server->count, sizeof(*tasks));
+	if (unlikely(server->listeners == NULL || tasks == NULL)) {
+		goto server_error;
+	}
+	/* Listeners join the reuseport group in scheduler order */
+	for (i = 0; i < server->count; i++) {
+		listener = &server->listeners[i];
+		listener->server = server;
+		listener->sched = rinoo_spawn_get(sched, i);
+		listener->id = listener->sched->id;
+		if (ip != NULL) {
+			addr = *ip;
+		}
+		listener->socket = rinoo_tcp_server(listener->sched, (ip != NULL ? &addr : NULL), port);
+		if (listener->socket == NULL) {
+			goto server_error;
+		}
+		tasks[i] = rinoo_task(listener->sched, &listener->sched->driver.main, rinoo_tcp_spawned_accept, listener);
+		if (tasks[i] == NULL) {
+			goto server_error;
+		}
+	}
+	/* Accept tasks only get scheduled once nothing else can fail */
+	for (i = 0; i < server->count; i++) {
+		rinoo_task_schedule(tasks[i], NULL);
+	}
+	free(tasks);
+	return server;
+server_error:
+	for (i = 0; server->listeners != NULL && i < server->count; i++) {
+		if (tasks != NULL && tasks[i] != NULL) {
+			rinoo_task_destroy(tasks[i]);
+		}
+		if (server->listeners[i].socket != NULL) {
+			rinoo_socket_destroy(server->listeners[i].socket);
+		}
+	}
+	free(tasks);
+	free(server->listeners);
+	free(server);
+	return NULL;
+}
+
+/**
+ * Steers new connections to the scheduler pinned to the CPU which
+ * received them. A classic BPF program selects listener cpu % count and
+ * every scheduler thread gets pinned to the CPU matching its id once its
+ * loop starts, so there must be as many schedulers (main one included)
+ * as online CPUs. Note that the main scheduler thread, which calls
+ * rinoo_sched_loop, gets pinned to CPU 0 as well.
+ * Must be called before running the main scheduler loop.
+ *
+ * @param server Spawned server to steer
+ *
+ * @return 0 on success or -1 if an error occurs (EINVAL if the number of schedulers and CPUs differ)
+ */
+int rinoo_tcp_server_spawned_steer(t_tcp_spawned *server)
+{
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+	struct sock_filter code[] = {
+		/* A = raw_smp_processor_id() */
+		{ BPF_LD | BPF_W | BPF_ABS, 0, 0, SKF_AD_OFF + SKF_AD_CPU },
+		/* A = A % count */
+		{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, server->count },
+		/* Return A as listener index */
+		{ BPF_RET | BPF_A, 0, 0, 0 },
+	};
+	struct sock_fprog prog = { .len = ARRAY_SIZE(code), .filter = code };
+
+	XASSERT(server != NULL, -1);
+
+	/* Listener selection and thread pinning must match */
+	if (sysconf(_SC_NPROCESSORS_ONLN) != server->count) {
+		errno = EINVAL;
+		return -1;
+	}
+	/* The program applies to the whole reuseport group */
+	if (setsockopt(server->listeners[0].socket->node.fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) != 0) {
+		return -1;
+	}
+	server->steering = true;
+	return 0;
+#else
+	XASSERT(server != NULL, -1);
+
+	errno = EOPNOTSUPP;
+	return -1;
+#endif /* !SO_ATTACH_REUSEPORT_CBPF */
+}
+
+/**
+ * Logs the number of connections accepted by each scheduler of a
+ * spawned server and its accept rate since the server creation.
+ * Counters are updated by each scheduler thread, call it from the main
+ * scheduler or after the loop for exact values.
+ *
+ * @param server Spawned server to report
+ */
+void rinoo_tcp_server_spawned_report(t_tcp_spawned *server)
+{
+	int i;
+	double elapsed;
+	uint64_t total;
+
+	XASSERTN(server != NULL);
+
+	/* Only the main scheduler is still valid once spawns are stopped */
+	elapsed = (double) (server->listeners[0].sched->clock - server->start) / RINOO_NSEC_PER_SEC;
+	for (i = 0, total = 0; i < server->count; i++) {
+		total += server->listeners[i].accepted;
+	}
+	rinoo_log("TCP server: %llu connections accepted in %.3fs", (unsigned long long) total, elapsed);
+	for (i = 0; i < server->count; i++) {
+		rinoo_log("  scheduler %d: %llu accepted, %.1f/s", server->listeners[i].id,
+			  (unsigned long long) server->listeners[i].accepted,
+			  (elapsed > 0 ? server->listeners[i].accepted / elapsed : 0));
+	}
+}
+
+/**
+ * Destroys a spawned server. Listener sockets belong to their accept
+ * tasks, this must be called once schedulers are stopped.
+ *
+ * @param server Spawned server to destroy
+ */
+void rinoo_tcp_server_spawned_destroy(t_tcp_spawned *server)
+{
+	XASSERTN(server != NULL);
+
+	free(server->listeners);
+	free(server);
+}
@@ -0,0 +1,181 @@
+/**
+ * @file   rinoo_socket_coalesce.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 21:37:09 2026
+ *
+ * @brief  Socket write coalescing unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBWRITES	10
+#define LARGE_SIZE	8192
+
+extern const t_socket_class socket_class_tcp;
+
+int checker = 0;
+bool received = false;
+t_socket *client;
+
+void process_client(void *socket)
+{
+	int i;
+	char b;
+	char buf[LARGE_SIZE];
+
+	/* Small writes come out of a single syscall */
+	XTEST(rinoo_socket_read(socket, buf, sizeof(buf)) == NBWRITES * 5);
+	for (i = 0; i < NBWRITES; i++) {
+		XTEST(memcmp(buf + i * 5, "hello", 5) == 0);
+	}
+	XTEST(rinoo_socket_write(socket, "a", 1) == 1);
+	/* Explicit flush */
+	XTEST(rinoo_socket_read(socket, buf, sizeof(buf)) == 3);
+	XTEST(memcmp(buf, "abc", 3) == 0);
+	/* Pending data followed by a large write */
+	XTEST(rinoo_socket_read_exact(socket, buf, 3) == 3);
+	XTEST(memcmp(buf, "def", 3) == 0);
+	XTEST(rinoo_socket_read_exact(socket, buf, LARGE_SIZE) == LARGE_SIZE);
+	XTEST(buf[0] == 'z' && buf[LARGE_SIZE - 1] == 'z');
+	/* Flushed when the writing task ends */
+	XTEST(rinoo_socket_read(socket, &b, 1) == 1);
+	XTEST(b == 'e');
+	XTEST(rinoo_socket_write(socket, "b", 1) == 1);
+	XTEST(rinoo_socket_read(socket, &b, 1) == -1);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+void server_func(void *sched)
+{
+	t_socket *server;
+	t_socket *socket;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	socket = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(socket != NULL);
+	rinoo_task_start(sched, process_client, socket);
+	rinoo_socket_destroy(server);
+}
+
+void ending_func(void *unused(arg))
+{
+	XTEST(rinoo_socket_write(client, "e", 1) == 1);
+	XTEST(client->coalesce.len == 1);
+}
+
+void dropping_func(void *sched)
+{
+	t_socket *socket;
+
+	/* Data which cannot be flushed on close is counted */
+	socket = rinoo_socket(sched, &socket_class_tcp);
+	XTEST(socket != NULL);
+	XTEST(rinoo_socket_coalesce(socket, 1024) == 0);
+	XTEST(rinoo_socket_write(socket, "lost", 4) == 4);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+void release_server_func(void *sched)
+{
+	char b;
+	t_socket *server;
+	t_socket *socket;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4243);
+	XTEST(server != NULL);
+	socket = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(socket != NULL);
+	XTEST(rinoo_socket_read(socket, &b, 1) == 1);
+	XTEST(b == 'r');
+	received = true;
+	rinoo_socket_destroy(socket);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void release_func(void *sched)
+{
+	t_task *self;
+	t_socket *socket;
+
+	socket = rinoo_tcp_client(sched, IP_LOOPBACK, 4243, 1000);
+	XTEST(socket != NULL);
+	XTEST(rinoo_socket_coalesce(socket, 64) == 0);
+	XTEST(rinoo_socket_write(socket, "r", 1) == 1);
+	XTEST(socket->coalesce.len == 1);
+	/* Releasing the task directly flushes as well */
+	self = rinoo_task_self();
+	XTEST(rinoo_task_schedule_ns(self, ((t_sched *) sched)->clock + 50 * RINOO_NSEC_PER_MSEC) == 0);
+	XTEST(rinoo_task_release(sched) == 0);
+	XTEST(socket->coalesce.len == 0);
+	XTEST(received);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+void client_func(void *sched)
+{
+	int i;
+	char b;
+	char *large;
+
+	client = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_coalesce(client, 1024) == 0);
+	for (i = 0; i < NBWRITES; i++) {
+		XTEST(rinoo_socket_write(client, "hello", 5) == 5);
+	}
+	XTEST(client->coalesce.len == NBWRITES * 5);
+	/* Waiting for the answer flushes */
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'a');
+	XTEST(client->coalesce.writes == NBWRITES);
+	XTEST(client->coalesce.flushes == 1);
+	XTEST(rinoo_socket_write(client, "ab", 2) == 2);
+	XTEST(rinoo_socket_write(client, "c", 1) == 1);
+	XTEST(rinoo_socket_flush(client) == 0);
+	XTEST(client->coalesce.len == 0);
+	rinoo_task_wait(sched, 20);
+	XTEST(rinoo_socket_write(client, "def", 3) == 3);
+	large = malloc(LARGE_SIZE);
+	XTEST(large != NULL);
+	memset(large, 'z', LARGE_SIZE);
+	XTEST(rinoo_socket_write(client, large, LARGE_SIZE) == LARGE_SIZE);
+	XTEST(client->coalesce.len == 0);
+	free(large);
+	XTEST(rinoo_task_start(sched, ending_func, NULL) == 0);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'b');
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, release_server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, release_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	XTEST(sched->dropped == 0);
+	XTEST(rinoo_task_start(sched, dropping_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	XTEST(sched->dropped == 4);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 5);
+	XPASS();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file   rinoo_socket_mmsg.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 15:41:09 2026
+ *
+ * @brief  rinoo_socket_recvmmsg/rinoo_socket_sendmmsg unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NB_DATAGRAMS	100
+#define DATAGRAM_SIZE	64
+
+extern const t_socket_class socket_class_udp;
+
+int checker = 0;
+
+char server_data[NB_DATAGRAMS][DATAGRAM_SIZE];
+t_buffer server_buffers[NB_DATAGRAMS];
+t_socket_msg server_msgs[NB_DATAGRAMS];
+
+char client_data[NB_DATAGRAMS][DATAGRAM_SIZE];
+t_buffer client_buffers[NB_DATAGRAMS];
+t_socket_msg client_msgs[NB_DATAGRAMS];
+
+void server_func(void *sched)
+{
+	int i;
+	int ret;
+	int received;
+	t_socket *server;
+	struct sockaddr_in addr;
+
+	server = rinoo_socket(sched, &socket_class_udp);
+	XTEST(server != NULL);
+	addr.sin_port = htons(4242);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	XTEST(rinoo_socket_bind(server, (struct sockaddr *) &addr, sizeof(addr), 0) == 0);
+	for (i = 0; i < NB_DATAGRAMS; i++) {
+		buffer_set(&server_buffers[i], server_data[i], DATAGRAM_SIZE);
+		server_msgs[i].buffer = &server_buffers[i];
+	}
+	for (received = 0; received < NB_DATAGRAMS; received += ret) {
+		ret = rinoo_socket_recvmmsg(server, &server_msgs[received], NB_DATAGRAMS - received);
+		rinoo_log("server - received %d datagrams", ret);
+		XTEST(ret > 0);
+	}
+	for (i = 0; i < NB_DATAGRAMS; i++) {
+		XTEST(buffer_size(&server_buffers[i]) == (size_t) i % DATAGRAM_SIZE + 1);
+		XTEST(server_data[i][0] == (char) i);
+		XTEST(server_msgs[i].addrlen == sizeof(struct sockaddr_in));
+		XTEST(server_msgs[i].addr.v4.sin_port == server_msgs[0].addr.v4.sin_port);
+	}
+	/* Echo every datagram back to its sender */
+	XTEST(rinoo_socket_sendmmsg(server, server_msgs, NB_DATAGRAMS) == NB_DATAGRAMS);
+	checker++;
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	int ret;
+	int received;
+	t_socket *client;
+
+	client = rinoo_udp_client(sched, IP_LOOPBACK, 4242);
+	XTEST(client != NULL);
+	for (i = 0; i < NB_DATAGRAMS; i++) {
+		memset(client_data[i], i, DATAGRAM_SIZE);
+		buffer_set(&client_buffers[i], client_data[i], DATAGRAM_SIZE);
+		buffer_setsize(&client_buffers[i], i % DATAGRAM_SIZE + 1);
+		client_msgs[i].buffer = &client_buffers[i];
+		client_msgs[i].addrlen = 0;
+	}
+	XTEST(rinoo_socket_sendmmsg(client, client_msgs, NB_DATAGRAMS) == NB_DATAGRAMS);
+	memset(client_data, 0, sizeof(client_data));
+	for (received = 0; received < NB_DATAGRAMS; received += ret) {
+		ret = rinoo_socket_recvmmsg(client, &client_msgs[received], NB_DATAGRAMS - received);
+		XTEST(ret > 0);
+	}
+	for (i = 0; i < NB_DATAGRAMS; i++) {
+		XTEST(buffer_size(&client_buffers[i]) == (size_t) i % DATAGRAM_SIZE + 1);
+		XTEST(client_data[i][i % DATAGRAM_SIZE] == (char) i);
+	}
+	checker++;
+	rinoo_socket_destroy(client);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file   rinoo_socket_option.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 21:48:30 2026
+ *
+ * @brief  Socket options and listener defaults unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+int checker = 0;
+t_sched *sched;
+
+void check_defaults(t_socket *socket)
+{
+	int value;
+
+	XTEST(rinoo_socket_get_option(socket, RINOO_SOCKET_NODELAY, &value) == 0);
+	XTEST(value != 0);
+	XTEST(rinoo_socket_get_option(socket, RINOO_SOCKET_KEEPALIVE, &value) == 0);
+	XTEST(value != 0);
+	XTEST(rinoo_socket_get_option(socket, RINOO_SOCKET_KEEPIDLE, &value) == 0);
+	XTEST(value == 30);
+	XTEST(rinoo_socket_get_option(socket, RINOO_SOCKET_TOS, &value) == 0);
+	XTEST(value == 0x10);
+}
+
+void set_defaults(t_socket *server)
+{
+	XTEST(rinoo_socket_set_default(server, RINOO_SOCKET_NODELAY, 1) == 0);
+	XTEST(rinoo_socket_set_default(server, RINOO_SOCKET_KEEPALIVE, 1) == 0);
+	XTEST(rinoo_socket_set_default(server, RINOO_SOCKET_KEEPIDLE, 30) == 0);
+	XTEST(rinoo_socket_set_default(server, RINOO_SOCKET_TOS, 0x10) == 0);
+}
+
+void tcp_server_func(void *unused(arg))
+{
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	set_defaults(server);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	check_defaults(client);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void ssl_server_func(void *ctx)
+{
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_ssl_server(sched, ctx, IP_ANY, 4243);
+	XTEST(server != NULL);
+	set_defaults(server);
+	client = rinoo_ssl_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	check_defaults(client);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void client_func(void *ctx)
+{
+	int value;
+	t_socket *client;
+
+	client = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_set_option(client, RINOO_SOCKET_NODELAY, 1) == 0);
+	XTEST(rinoo_socket_get_option(client, RINOO_SOCKET_NODELAY, &value) == 0 && value != 0);
+	XTEST(rinoo_socket_set_option(client, RINOO_SOCKET_SNDBUF, 65536) == 0);
+	XTEST(rinoo_socket_get_option(client, RINOO_SOCKET_SNDBUF, &value) == 0 && value >= 65536);
+	XTEST(rinoo_socket_set_option(client, RINOO_SOCKET_NOTSENT_LOWAT, 16384) == 0);
+	XTEST(rinoo_socket_get_option(client, RINOO_SOCKET_NOTSENT_LOWAT, &value) == 0 && value == 16384);
+	XTEST(rinoo_socket_set_option(client, RINOO_SOCKET_QUICKACK, 1) == 0);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	rinoo_socket_destroy(client);
+
+	client = rinoo_ssl_client(sched, ctx, IP_LOOPBACK, 4243, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_set_option(client, RINOO_SOCKET_NODELAY, 1) == 0);
+	XTEST(rinoo_socket_get_option(client, RINOO_SOCKET_NODELAY, &value) == 0 && value != 0);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_ssl_ctx *ctx;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ctx = rinoo_ssl_context();
+	XTEST(ctx != NULL);
+	XTEST(rinoo_task_start(sched, tcp_server_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, ssl_server_func, ctx) == 0);
+	XTEST(rinoo_task_start(sched, client_func, ctx) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_ssl_context_destroy(ctx);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 3);
+	XPASS();
+}
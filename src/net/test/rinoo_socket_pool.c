@@ -0,0 +1,196 @@
+/**
+ * @file   rinoo_socket_pool.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 18:21:37 2026
+ *
+ * @brief  Client connection pool unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+int checker = 0;
+bool timedout = false;
+bool cancelled = false;
+t_socket_pool *pool;
+t_socket_pool *other;
+
+void process_client(void *socket)
+{
+	char c;
+
+	while (rinoo_socket_read(socket, &c, 1) == 1 && c != 'q') {
+		XTEST(rinoo_socket_write(socket, &c, 1) == 1);
+	}
+	rinoo_socket_destroy(socket);
+}
+
+void server_func(void *sched)
+{
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	while ((client = rinoo_tcp_accept(server, NULL, NULL)) != NULL) {
+		rinoo_task_start(sched, process_client, client);
+	}
+	rinoo_socket_destroy(server);
+}
+
+int echo(t_socket *socket, char c)
+{
+	char r;
+
+	if (rinoo_socket_write(socket, &c, 1) != 1 || rinoo_socket_read(socket, &r, 1) != 1) {
+		return -1;
+	}
+	return (r == c ? 0 : -1);
+}
+
+void waiter_func(void *unused(arg))
+{
+	t_socket *socket;
+
+	/* Endpoint limit is reached, this waits for a release */
+	socket = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(socket != NULL);
+	XTEST(echo(socket, 'w') == 0);
+	checker++;
+	rinoo_socket_pool_release(pool, socket);
+}
+
+void deadline_func(void *sched)
+{
+	uint64_t start;
+
+	/* The task deadline is shorter than the pool timeout */
+	start = ((t_sched *) sched)->clock;
+	XTEST(rinoo_task_deadline(sched, 20) == 0);
+	XTEST(rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL) == NULL);
+	XTEST(errno == ETIMEDOUT);
+	XTEST(((t_sched *) sched)->clock - start < 500 * RINOO_NSEC_PER_MSEC);
+	timedout = true;
+}
+
+void cancelled_func(void *unused(arg))
+{
+	/* No timeout, only the pool destruction wakes this task up */
+	XTEST(rinoo_socket_pool_acquire(other, IP_LOOPBACK, 4242, NULL) == NULL);
+	XTEST(errno == ECANCELED);
+	cancelled = true;
+}
+
+void destroy_test(t_sched *sched)
+{
+	t_socket *socket;
+	t_socket_pool_config config = {
+		.max_idle = 1,
+		.max_per_endpoint = 1,
+		.idle_timeout = 0,
+		.timeout = 0,
+		.check = NULL
+	};
+
+	other = rinoo_socket_pool(sched, &config);
+	XTEST(other != NULL);
+	socket = rinoo_socket_pool_acquire(other, IP_LOOPBACK, 4242, NULL);
+	XTEST(socket != NULL);
+	XTEST(rinoo_task_start(sched, cancelled_func, NULL) == 0);
+	rinoo_task_wait(sched, 20);
+	XTEST(other->stats.waited == 1);
+	XTEST(!cancelled);
+	rinoo_socket_pool_destroy(other);
+	rinoo_task_wait(sched, 20);
+	XTEST(cancelled);
+	rinoo_socket_destroy(socket);
+}
+
+void client_func(void *sched)
+{
+	t_socket *s1;
+	t_socket *s2;
+
+	/* Reuse */
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(s1 != NULL);
+	XTEST(echo(s1, 'a') == 0);
+	rinoo_socket_pool_release(pool, s1);
+	s2 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(s2 == s1);
+	XTEST(echo(s2, 'b') == 0);
+	XTEST(pool->stats.created == 1);
+	XTEST(pool->stats.reused == 1);
+
+	/* Per endpoint limit */
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(s1 != NULL && s1 != s2);
+	XTEST(rinoo_task_start(sched, waiter_func, NULL) == 0);
+	rinoo_task_wait(sched, 50);
+	XTEST(pool->stats.waited == 1);
+	XTEST(checker == 0);
+	XTEST(rinoo_task_start(sched, deadline_func, sched) == 0);
+	rinoo_task_wait(sched, 50);
+	XTEST(timedout);
+	rinoo_socket_pool_release(pool, s1);
+	rinoo_task_wait(sched, 50);
+	XTEST(checker == 1);
+	XTEST(pool->stats.created == 2);
+
+	/* Health check: the server closes connections on 'q' */
+	XTEST(rinoo_socket_write(s2, "q", 1) == 1);
+	rinoo_socket_pool_release(pool, s2);
+	rinoo_task_wait(sched, 50);
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(s1 != NULL);
+	XTEST(pool->stats.unhealthy == 1);
+	XTEST(echo(s1, 'c') == 0);
+	rinoo_socket_pool_discard(pool, s1);
+
+	/* Idle timeout */
+	rinoo_task_wait(sched, 150);
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, NULL);
+	XTEST(s1 != NULL);
+	XTEST(pool->stats.expired == 1);
+	XTEST(echo(s1, 'd') == 0);
+	rinoo_socket_pool_release(pool, s1);
+
+	/* Destruction with a waiting task */
+	destroy_test(sched);
+	rinoo_log("pool - created: %llu, reused: %llu, expired: %llu, unhealthy: %llu, waited: %llu",
+		  (unsigned long long) pool->stats.created, (unsigned long long) pool->stats.reused,
+		  (unsigned long long) pool->stats.expired, (unsigned long long) pool->stats.unhealthy,
+		  (unsigned long long) pool->stats.waited);
+	checker++;
+	rinoo_sched_stop(sched);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+	t_socket_pool_config config = {
+		.max_idle = 2,
+		.max_per_endpoint = 2,
+		.idle_timeout = 100,
+		.timeout = 1000,
+		.check = NULL
+	};
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	pool = rinoo_socket_pool(sched, &config);
+	XTEST(pool != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_socket_pool_destroy(pool);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
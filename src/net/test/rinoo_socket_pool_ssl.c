@@ -0,0 +1,144 @@
+/**
+ * @file   rinoo_socket_pool_ssl.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 15:02:44 2026
+ *
+ * @brief  Client connection pool health check unit test with SSL
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+int checker = 0;
+t_socket_pool *pool;
+t_ssl_ctx *server_ctx;
+
+void process_client(void *socket)
+{
+	char c;
+
+	while (rinoo_socket_read(socket, &c, 1) == 1 && c != 'q') {
+		if (c == 'r') {
+			XTEST(rinoo_socket_write(socket, "rr", 2) == 2);
+		} else {
+			XTEST(rinoo_socket_write(socket, &c, 1) == 1);
+		}
+	}
+	/* Sends close_notify then FIN */
+	rinoo_socket_destroy(socket);
+}
+
+void server_func(void *sched)
+{
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_ssl_server(sched, server_ctx, IP_ANY, 4242);
+	XTEST(server != NULL);
+	while ((client = rinoo_ssl_accept(server, NULL, NULL)) != NULL) {
+		rinoo_task_start(sched, process_client, client);
+	}
+	rinoo_socket_destroy(server);
+}
+
+int echo(t_socket *socket, char c)
+{
+	char r;
+
+	if (rinoo_socket_write(socket, &c, 1) != 1 || rinoo_socket_read(socket, &r, 1) != 1) {
+		return -1;
+	}
+	return (r == c ? 0 : -1);
+}
+
+void check_ctx(t_sched *sched, t_ssl_ctx *ctx)
+{
+	char c;
+	t_socket *s1;
+	t_socket *s2;
+	uint64_t created;
+	uint64_t unhealthy;
+
+	created = pool->stats.created;
+	unhealthy = pool->stats.unhealthy;
+	/* Post-handshake records do not prevent reuse */
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, ctx);
+	XTEST(s1 != NULL);
+	XTEST(echo(s1, 'a') == 0);
+	rinoo_socket_pool_release(pool, s1);
+	rinoo_task_wait(sched, 20);
+	s2 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, ctx);
+	XTEST(s2 == s1);
+	XTEST(echo(s2, 'b') == 0);
+
+	/* The server closes an idle connection */
+	XTEST(rinoo_socket_write(s2, "q", 1) == 1);
+	rinoo_socket_pool_release(pool, s2);
+	rinoo_task_wait(sched, 50);
+	s1 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, ctx);
+	XTEST(s1 != NULL);
+	XTEST(pool->stats.unhealthy == unhealthy + 1);
+	XTEST(pool->stats.created == created + 2);
+	XTEST(echo(s1, 'c') == 0);
+
+	/* Data left in the read-ahead buffer */
+	XTEST(rinoo_socket_readahead(s1, 64) == 0);
+	XTEST(rinoo_socket_write(s1, "r", 1) == 1);
+	XTEST(rinoo_socket_read(s1, &c, 1) == 1);
+	XTEST(c == 'r');
+	rinoo_socket_pool_release(pool, s1);
+	s2 = rinoo_socket_pool_acquire(pool, IP_LOOPBACK, 4242, ctx);
+	XTEST(s2 != NULL);
+	XTEST(pool->stats.unhealthy == unhealthy + 2);
+	XTEST(echo(s2, 'd') == 0);
+	rinoo_socket_pool_discard(pool, s2);
+}
+
+void client_func(void *sched)
+{
+	t_ssl_ctx *ctx;
+
+	/* Socket BIO */
+	ctx = rinoo_ssl_context();
+	XTEST(ctx != NULL);
+	check_ctx(sched, ctx);
+	/* Memory BIOs */
+	XTEST(rinoo_ssl_context_membio(ctx, RINOO_SSL_MEMBIO_SIZE) == 0);
+	check_ctx(sched, ctx);
+	rinoo_socket_pool_destroy(pool);
+	rinoo_ssl_context_destroy(ctx);
+	checker++;
+	rinoo_sched_stop(sched);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+	t_socket_pool_config config = {
+		.max_idle = 2,
+		.max_per_endpoint = 0,
+		.idle_timeout = 0,
+		.timeout = 1000,
+		.check = NULL
+	};
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	server_ctx = rinoo_ssl_context();
+	XTEST(server_ctx != NULL);
+	pool = rinoo_socket_pool(sched, &config);
+	XTEST(pool != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	rinoo_ssl_context_destroy(server_ctx);
+	XTEST(checker == 1);
+	XPASS();
+}
@@ -0,0 +1,113 @@
+/**
+ * @file   rinoo_socket_readahead.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 19:02:15 2026
+ *
+ * @brief  Socket read-ahead, peek and read_exact unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBFRAMES	100
+#define READAHEAD_SIZE	256
+#define LARGE_SIZE	(READAHEAD_SIZE * 8)
+
+int checker = 0;
+
+void process_client(void *socket)
+{
+	int i;
+	char *ptr;
+	uint32_t len;
+	char payload[64];
+	char large[LARGE_SIZE];
+	t_buffer *buffer;
+
+	XTEST(rinoo_socket_readahead(socket, READAHEAD_SIZE) == 0);
+	/* Length prefixed frames */
+	for (i = 0; i < NBFRAMES; i++) {
+		ptr = rinoo_socket_peek(socket, sizeof(len));
+		XTEST(ptr != NULL);
+		memcpy(&len, ptr, sizeof(len));
+		XTEST(len == (uint32_t) (i % sizeof(payload)) + 1);
+		XTEST(rinoo_socket_consume(socket, sizeof(len)) == 0);
+		XTEST(rinoo_socket_read_exact(socket, payload, len) == (ssize_t) len);
+		XTEST(payload[0] == 'a' + i % 26 && payload[len - 1] == 'a' + i % 26);
+	}
+	XTEST(rinoo_socket_peek(socket, READAHEAD_SIZE + 1) == NULL);
+	/* Larger than the read-ahead buffer */
+	XTEST(rinoo_socket_read_exact(socket, large, LARGE_SIZE) == LARGE_SIZE);
+	for (i = 0; i < LARGE_SIZE; i++) {
+		XTEST(large[i] == 'z');
+	}
+	/* Line protocol */
+	buffer = buffer_create(NULL);
+	XTEST(buffer != NULL);
+	XTEST(rinoo_socket_readline(socket, buffer, "\n", 64) == 6);
+	XTEST(buffer_strncmp(buffer, "hello\n", 6) == 0);
+	buffer_erase(buffer, 6);
+	XTEST(rinoo_socket_readline(socket, buffer, "\n", 64) == 6);
+	XTEST(buffer_strncmp(buffer, "world\n", 6) == 0);
+	buffer_destroy(buffer);
+	XTEST(rinoo_socket_read_exact(socket, payload, 1) == -1);
+	XTEST(rinoo_socket_readahead(socket, 0) == 0);
+	checker++;
+	rinoo_socket_destroy(socket);
+}
+
+void server_func(void *sched)
+{
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_task_start(sched, process_client, client);
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	uint32_t len;
+	char frame[sizeof(len) + 64];
+	char large[LARGE_SIZE];
+	t_socket *client;
+
+	client = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	for (i = 0; i < NBFRAMES; i++) {
+		len = i % 64 + 1;
+		memcpy(frame, &len, sizeof(len));
+		memset(frame + sizeof(len), 'a' + i % 26, len);
+		XTEST(rinoo_socket_write(client, frame, sizeof(len) + len) == (ssize_t) (sizeof(len) + len));
+	}
+	memset(large, 'z', LARGE_SIZE);
+	XTEST(rinoo_socket_write(client, large, LARGE_SIZE) == LARGE_SIZE);
+	XTEST(rinoo_socket_write(client, "hello\nworld\n", 12) == 12);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file   rinoo_socket_splice.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 19:58:26 2026
+ *
+ * @brief  rinoo_socket_splice unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define TRANSFER_SIZE	(1024 * 1000)
+
+int checker = 0;
+
+void backend_func(void *sched)
+{
+	char *buf;
+	size_t total;
+	ssize_t res;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4243);
+	XTEST(server != NULL);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_socket_destroy(server);
+	buf = malloc(TRANSFER_SIZE);
+	XTEST(buf != NULL);
+	total = 0;
+	while ((res = rinoo_socket_read(client, buf, TRANSFER_SIZE)) > 0) {
+		XTEST(buf[0] == 'a' && buf[res - 1] == 'a');
+		total += res;
+	}
+	XTEST(total == TRANSFER_SIZE);
+	free(buf);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+void proxy_func(void *sched)
+{
+	size_t total;
+	ssize_t res;
+	t_socket *server;
+	t_socket *client;
+	t_socket *backend;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_socket_destroy(server);
+	backend = rinoo_tcp_client(sched, IP_LOOPBACK, 4243, 1000);
+	XTEST(backend != NULL);
+	/* Buffered data is forwarded first */
+	XTEST(rinoo_socket_readahead(client, 64) == 0);
+	XTEST(rinoo_socket_peek(client, 4) != NULL);
+	XTEST(memcmp(rinoo_socket_peek(client, 4), "PRXY", 4) == 0);
+	XTEST(rinoo_socket_consume(client, 4) == 0);
+	total = 0;
+	while ((res = rinoo_socket_splice(client, backend, 65536)) > 0) {
+		total += res;
+	}
+	XTEST(total == TRANSFER_SIZE);
+	/* The pipe went back to the scheduler pool */
+	XTEST(((t_sched *) sched)->pipes.count == 1);
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(backend);
+	checker++;
+}
+
+void client_func(void *sched)
+{
+	char *buf;
+	t_socket *client;
+
+	client = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	buf = malloc(TRANSFER_SIZE + 4);
+	XTEST(buf != NULL);
+	memcpy(buf, "PRXY", 4);
+	memset(buf + 4, 'a', TRANSFER_SIZE);
+	XTEST(rinoo_socket_write(client, buf, TRANSFER_SIZE + 4) == TRANSFER_SIZE + 4);
+	free(buf);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, backend_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, proxy_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 3);
+	XPASS();
+}
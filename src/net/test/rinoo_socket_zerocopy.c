@@ -0,0 +1,105 @@
+/**
+ * @file   rinoo_socket_zerocopy.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 15:02:37 2026
+ *
+ * @brief  MSG_ZEROCOPY write unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define TRANSFER_SIZE	(256 * 1024)
+
+extern const t_socket_class socket_class_tcp;
+
+void process_client(void *arg)
+{
+	size_t i;
+	ssize_t ret;
+	size_t total;
+	unsigned char *buf;
+	t_socket *socket = arg;
+
+	buf = malloc(TRANSFER_SIZE);
+	XTEST(buf != NULL);
+	for (total = 0; total < 2 * TRANSFER_SIZE; total += ret) {
+		ret = rinoo_socket_read(socket, buf, TRANSFER_SIZE);
+		XTEST(ret > 0);
+		for (i = 0; i < (size_t) ret; i++) {
+			XTEST(buf[i] == (unsigned char) ((total + i) % TRANSFER_SIZE % 251));
+		}
+	}
+	rinoo_log("server - received %zu bytes", total);
+	free(buf);
+	rinoo_socket_destroy(socket);
+}
+
+void server_func(void *arg)
+{
+	t_socket *server;
+	t_socket *client;
+	struct sockaddr_in addr;
+	t_sched *sched = arg;
+
+	server = rinoo_socket(sched, &socket_class_tcp);
+	XTEST(server != NULL);
+	addr.sin_port = htons(4242);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = 0;
+	XTEST(rinoo_socket_bind(server, (struct sockaddr *) &addr, sizeof(addr), 42) == 0);
+	client = rinoo_socket_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_task_start(sched, process_client, client);
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *arg)
+{
+	size_t i;
+	unsigned char *buf;
+	t_socket *socket;
+	struct sockaddr_in addr;
+	t_sched *sched = arg;
+
+	buf = malloc(TRANSFER_SIZE);
+	XTEST(buf != NULL);
+	for (i = 0; i < TRANSFER_SIZE; i++) {
+		buf[i] = i % 251;
+	}
+	socket = rinoo_socket(sched, &socket_class_tcp);
+	XTEST(socket != NULL);
+	addr.sin_port = htons(4242);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = 0;
+	XTEST(rinoo_socket_connect(socket, (struct sockaddr *) &addr, sizeof(addr)) == 0);
+	XTEST(rinoo_socket_zerocopy(socket, 4096) == 0);
+	XTEST(rinoo_socket_write(socket, buf, TRANSFER_SIZE) == TRANSFER_SIZE);
+	rinoo_log("client - zerocopy sent: %u, completed: %u, copied: %u", socket->zerocopy.sent, socket->zerocopy.completed, socket->zerocopy.copied);
+	XTEST(socket->zerocopy.sent > 0);
+	XTEST(socket->zerocopy.sent == socket->zerocopy.completed);
+	/* Buffer has been released by the kernel, it can be reused */
+	XTEST(rinoo_socket_write(socket, buf, TRANSFER_SIZE) == TRANSFER_SIZE);
+	XTEST(socket->zerocopy.sent == socket->zerocopy.completed);
+	rinoo_socket_destroy(socket);
+	free(buf);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XPASS();
+}
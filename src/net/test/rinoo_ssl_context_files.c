@@ -0,0 +1,132 @@
+/**
+ * @file   rinoo_ssl_context_files.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 23:48:51 2026
+ *
+ * @brief  SSL context from files unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define CERT_PATH	"/tmp/rinoo_ssl_test.crt"
+#define KEY_PATH	"/tmp/rinoo_ssl_test.key"
+
+int checker = 0;
+t_sched *sched;
+t_ssl_ctx *server_ctx;
+t_ssl_ctx *old_ctx;
+
+void server_func(void *unused(arg))
+{
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_ssl_server(sched, server_ctx, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_ssl_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(rinoo_socket_write(client, &b, 1) == 1);
+	rinoo_socket_destroy(client);
+	/* TLS 1.2 clients are refused */
+	XTEST(rinoo_ssl_accept(server, NULL, NULL) == NULL);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void client_func(void *unused(arg))
+{
+	char b;
+	SSL *ssl;
+	t_socket *client;
+
+	client = rinoo_ssl_client(sched, server_ctx, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	ssl = rinoo_ssl_get(client)->ssl;
+	rinoo_log("client - %s %s", SSL_get_version(ssl), SSL_get_cipher_name(ssl));
+	XTEST(SSL_version(ssl) == TLS1_3_VERSION);
+	XTEST(strcmp(SSL_get_cipher_name(ssl), "TLS_CHACHA20_POLY1305_SHA256") == 0);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	rinoo_socket_destroy(client);
+	client = rinoo_ssl_client(sched, old_ctx, IP_LOOPBACK, 4242, 1000);
+	XTEST(client == NULL);
+	checker++;
+}
+
+void write_files(void)
+{
+	FILE *file;
+	t_ssl_ctx *ctx;
+
+	ctx = rinoo_ssl_context_ecdsa();
+	XTEST(ctx != NULL);
+	XTEST(EVP_PKEY_id(ctx->pkey) == EVP_PKEY_EC);
+	file = fopen(CERT_PATH, "w");
+	XTEST(file != NULL);
+	XTEST(PEM_write_X509(file, ctx->x509) == 1);
+	fclose(file);
+	file = fopen(KEY_PATH, "w");
+	XTEST(file != NULL);
+	XTEST(PEM_write_PrivateKey(file, ctx->pkey, NULL, NULL, 0, NULL, NULL) == 1);
+	fclose(file);
+	rinoo_ssl_context_destroy(ctx);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_ssl_ctx *ctx;
+	t_ssl_ctx *other;
+	t_ssl_options options = {
+		.tls13_only = true,
+		.ciphers = NULL,
+		.ciphersuites = "TLS_CHACHA20_POLY1305_SHA256",
+		.groups = NULL
+	};
+
+	write_files();
+	XTEST(rinoo_ssl_context_from_files("/nonexistent.crt", KEY_PATH, NULL) == NULL);
+	server_ctx = rinoo_ssl_context_from_files(CERT_PATH, KEY_PATH, &options);
+	XTEST(server_ctx != NULL);
+	/* Same files and options share the parsed context */
+	ctx = rinoo_ssl_context_from_files(CERT_PATH, KEY_PATH, &options);
+	XTEST(ctx == server_ctx);
+	/* Shared contexts cannot be customized */
+	XTEST(rinoo_ssl_context_tickets(ctx, 60) == -1 && errno == EBUSY);
+	rinoo_ssl_context_destroy(ctx);
+	ctx = rinoo_ssl_context_from_files(CERT_PATH, KEY_PATH, NULL);
+	XTEST(ctx != NULL);
+	XTEST(ctx != server_ctx);
+	/* A customized context leaves the cache */
+	XTEST(rinoo_ssl_context_membio(ctx, RINOO_SSL_MEMBIO_SIZE) == 0);
+	other = rinoo_ssl_context_from_files(CERT_PATH, KEY_PATH, NULL);
+	XTEST(other != NULL);
+	XTEST(other != ctx);
+	XTEST(other->membio == 0);
+	rinoo_ssl_context_destroy(other);
+	rinoo_ssl_context_destroy(ctx);
+
+	old_ctx = rinoo_ssl_context_ecdsa();
+	XTEST(old_ctx != NULL);
+	XTEST(SSL_CTX_set_max_proto_version(old_ctx->ctx, TLS1_2_VERSION) == 1);
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, client_func, NULL) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	rinoo_ssl_context_destroy(old_ctx);
+	rinoo_ssl_context_destroy(server_ctx);
+	unlink(CERT_PATH);
+	unlink(KEY_PATH);
+	XTEST(checker == 2);
+	XPASS();
+}
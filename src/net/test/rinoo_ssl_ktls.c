@@ -0,0 +1,139 @@
+/**
+ * @file   rinoo_ssl_ktls.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 22:31:26 2026
+ *
+ * @brief  SSL kernel TLS offload unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define FILE_SIZE	(RINOO_SSL_RECORD_SIZE * 4 + 123)
+
+int fd;
+int checker = 0;
+bool expected = false;
+t_sched *sched;
+
+/**
+ * Checks whether the kernel TLS upper layer protocol is loaded.
+ *
+ * @return true if tcp_available_ulp lists tls
+ */
+bool ktls_available(void)
+{
+	FILE *file;
+	char ulp[256];
+	bool found = false;
+
+	file = fopen("/proc/sys/net/ipv4/tcp_available_ulp", "r");
+	if (file == NULL) {
+		return false;
+	}
+	while (fscanf(file, "%255s", ulp) == 1) {
+		if (strcmp(ulp, "tls") == 0) {
+			found = true;
+		}
+	}
+	fclose(file);
+	return found;
+}
+
+void process_client(void *arg)
+{
+	t_socket *socket = arg;
+
+	/* Works either offloaded or through the userspace fallback */
+	rinoo_log("server - kernel TLS %s", (rinoo_ssl_ktls(socket) ? "enabled" : "not available"));
+	if (expected) {
+		/* Writes and sendfile must take the offloaded branch */
+		XTEST(rinoo_ssl_ktls(socket));
+		XTEST(socket->class->sendfile(socket, fd, 0, 0) == 0);
+	} else if (!rinoo_ssl_ktls(socket)) {
+		XTEST(socket->class->sendfile(socket, fd, 0, 0) == -1 && errno == EOPNOTSUPP);
+	}
+	XTEST(rinoo_socket_write(socket, "head", 4) == 4);
+	XTEST(rinoo_socket_sendfile(socket, fd, 10, FILE_SIZE - 10) == FILE_SIZE - 10);
+	XTEST(rinoo_socket_write(socket, "tail", 4) == 4);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+void server_func(void *arg)
+{
+	t_socket *client;
+	t_socket *server;
+	t_ssl_ctx *ctx = arg;
+
+	server = rinoo_ssl_server(sched, ctx, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_ssl_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_task_start(sched, process_client, client);
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *arg)
+{
+	int i;
+	char *buf;
+	t_socket *client;
+	t_ssl_ctx *ctx = arg;
+
+	client = rinoo_ssl_client(sched, ctx, IP_LOOPBACK, 4242, 0);
+	XTEST(client != NULL);
+	buf = malloc(FILE_SIZE);
+	XTEST(buf != NULL);
+	XTEST(rinoo_socket_read_exact(client, buf, 4) == 4);
+	XTEST(memcmp(buf, "head", 4) == 0);
+	XTEST(rinoo_socket_read_exact(client, buf, FILE_SIZE - 10) == FILE_SIZE - 10);
+	for (i = 0; i < FILE_SIZE - 10; i++) {
+		XTEST(buf[i] == 'a' + (i + 10) % 26);
+	}
+	XTEST(rinoo_socket_read_exact(client, buf, 4) == 4);
+	XTEST(memcmp(buf, "tail", 4) == 0);
+	free(buf);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	int i;
+	char c;
+	char path[] = "/tmp/rinoo_ssl_ktls.XXXXXX";
+	t_ssl_ctx *ssl;
+
+	fd = mkstemp(path);
+	XTEST(fd >= 0);
+	unlink(path);
+	for (i = 0; i < FILE_SIZE; i++) {
+		c = 'a' + i % 26;
+		XTEST(write(fd, &c, 1) == 1);
+	}
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ssl = rinoo_ssl_context();
+	XTEST(ssl != NULL);
+#ifdef RINOO_SSL_KTLS
+	XTEST(rinoo_ssl_context_ktls(ssl, true) == 0);
+	expected = ktls_available();
+#else
+	XTEST(rinoo_ssl_context_ktls(ssl, true) == -1 && errno == EOPNOTSUPP);
+#endif /* !RINOO_SSL_KTLS */
+	rinoo_task_start(sched, server_func, ssl);
+	rinoo_task_start(sched, client_func, ssl);
+	rinoo_sched_loop(sched);
+	rinoo_ssl_context_destroy(ssl);
+	rinoo_sched_destroy(sched);
+	close(fd);
+	XTEST(checker == 2);
+	XPASS();
+}
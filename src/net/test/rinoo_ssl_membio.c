@@ -0,0 +1,99 @@
+/**
+ * @file   rinoo_ssl_membio.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Mon Oct 19 01:37:45 2026
+ *
+ * @brief  SSL memory BIO unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define DATA_SIZE	(RINOO_SSL_MEMBIO_SIZE * 8 + 17)
+
+int checker = 0;
+t_sched *sched;
+t_ssl_ctx *ssl;
+t_socket *peer = NULL;
+
+void server_func(void *unused(arg))
+{
+	char *buf;
+	t_socket *server;
+
+	server = rinoo_ssl_server(sched, ssl, IP_ANY, 4242);
+	XTEST(server != NULL);
+	peer = rinoo_ssl_accept(server, NULL, NULL);
+	XTEST(peer != NULL);
+	rinoo_socket_destroy(server);
+	buf = malloc(DATA_SIZE);
+	XTEST(buf != NULL);
+	XTEST(rinoo_socket_read_exact(peer, buf, DATA_SIZE) == DATA_SIZE);
+	XTEST(rinoo_socket_write(peer, buf, DATA_SIZE) == DATA_SIZE);
+	/* Input after an idle period */
+	XTEST(rinoo_socket_read(peer, buf, 1) == 1);
+	XTEST(buf[0] == 'x');
+	/* Waits idle until the client closes */
+	XTEST(rinoo_socket_read(peer, buf, 1) == -1);
+	free(buf);
+	rinoo_socket_destroy(peer);
+	checker++;
+}
+
+void client_func(void *unused(arg))
+{
+	int i;
+	char *buf;
+	t_socket *client;
+
+	client = rinoo_ssl_client(sched, ssl, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_ssl_get(client)->network != NULL);
+	buf = malloc(DATA_SIZE);
+	XTEST(buf != NULL);
+	for (i = 0; i < DATA_SIZE; i++) {
+		buf[i] = 'a' + i % 26;
+	}
+	XTEST(rinoo_socket_write(client, buf, DATA_SIZE) == DATA_SIZE);
+	memset(buf, 0, DATA_SIZE);
+	XTEST(rinoo_socket_read_exact(client, buf, DATA_SIZE) == DATA_SIZE);
+	for (i = 0; i < DATA_SIZE; i++) {
+		XTEST(buf[i] == 'a' + i % 26);
+	}
+	/* The server waits for input with nothing buffered */
+	rinoo_task_wait(sched, 10);
+	XTEST(peer != NULL);
+	XTEST(rinoo_ssl_get(peer)->network != NULL);
+	/* Ring buffers are released once the connection is idle */
+	rinoo_task_wait(sched, RINOO_SSL_MEMBIO_IDLE + 50);
+	XTEST(rinoo_ssl_get(peer)->network == NULL);
+	XTEST(rinoo_socket_write(client, "x", 1) == 1);
+	rinoo_task_wait(sched, 10);
+	XTEST(rinoo_ssl_get(peer)->network != NULL);
+	free(buf);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ssl = rinoo_ssl_context();
+	XTEST(ssl != NULL);
+	XTEST(rinoo_ssl_context_membio(ssl, 1024) == -1);
+	XTEST(rinoo_ssl_context_membio(ssl, RINOO_SSL_MEMBIO_SIZE) == 0);
+	XTEST(rinoo_task_start(sched, server_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, client_func, NULL) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_ssl_context_destroy(ssl);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
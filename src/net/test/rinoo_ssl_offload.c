@@ -0,0 +1,125 @@
+/**
+ * @file   rinoo_ssl_offload.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Mon Oct 19 00:58:12 2026
+ *
+ * @brief  SSL handshake offloading unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBCLIENTS	8
+
+int checker = 0;
+int ticks = 0;
+int clients = 0;
+bool done = false;
+t_sched *sched;
+t_ssl_ctx *ssl;
+
+void process_client(void *socket)
+{
+	char b;
+
+	XTEST(rinoo_socket_read(socket, &b, 1) == 1);
+	XTEST(rinoo_socket_write(socket, &b, 1) == 1);
+	rinoo_socket_destroy(socket);
+}
+
+void server_func(void *unused(arg))
+{
+	int i;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_ssl_server(sched, ssl, IP_ANY, 4242);
+	XTEST(server != NULL);
+	for (i = 0; i < NBCLIENTS; i++) {
+		client = rinoo_ssl_accept(server, NULL, NULL);
+		XTEST(client != NULL);
+		rinoo_task_start(sched, process_client, client);
+	}
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *unused(arg))
+{
+	char b;
+	t_socket *client;
+
+	client = rinoo_ssl_client(sched, ssl, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'a');
+	rinoo_socket_destroy(client);
+	if (++clients == NBCLIENTS) {
+		done = true;
+	}
+	checker++;
+}
+
+void timeout_func(void *unused(arg))
+{
+	int error;
+	SSL *conn;
+	t_ssl_offload_job job;
+
+	conn = SSL_new(ssl->ctx);
+	XTEST(conn != NULL);
+	SSL_set_connect_state(conn);
+	XTEST(rinoo_ssl_offload_job(&job, sched, conn) == 0);
+	XTEST(rinoo_task_deadline(sched, 1) == 0);
+	XTEST(rinoo_task_wait(sched, 10) == -1 && errno == ETIMEDOUT);
+	/* The task stays parked until the worker is done, then reports the timeout */
+	job.ret = 42;
+	XTEST(rinoo_ssl_offload_handshake(ssl->offload, &job, &error) == -1);
+	XTEST(errno == ETIMEDOUT);
+	XTEST(job.ret <= 1);
+	XTEST(rinoo_task_self()->deadline != 0);
+	XTEST(rinoo_task_deadline(sched, 0) == 0);
+	rinoo_ssl_offload_job_destroy(&job);
+	SSL_free(conn);
+	checker++;
+}
+
+void ticker_func(void *unused(arg))
+{
+	/* The scheduler keeps running other tasks during handshakes */
+	while (!done) {
+		ticks++;
+		rinoo_task_wait(sched, 1);
+	}
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	int i;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ssl = rinoo_ssl_context();
+	XTEST(ssl != NULL);
+	XTEST(rinoo_ssl_context_offload(ssl, 2) == 0);
+	XTEST(rinoo_task_start(sched, server_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, ticker_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, timeout_func, NULL) == 0);
+	for (i = 0; i < NBCLIENTS; i++) {
+		XTEST(rinoo_task_start(sched, client_func, NULL) == 0);
+	}
+	rinoo_sched_loop(sched);
+	rinoo_log("offload - %llu handshake steps on workers, %d ticks", (unsigned long long) ssl->offload->steps, ticks);
+	XTEST(ssl->offload->steps >= 2 * NBCLIENTS);
+	XTEST(ticks > 0);
+	rinoo_ssl_context_destroy(ssl);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == NBCLIENTS + 1);
+	XPASS();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file   rinoo_ssl_session.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 23:12:08 2026
+ *
+ * @brief  SSL session cache and tickets unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBCONNS	6
+
+int checker = 0;
+t_sched *sched;
+t_ssl_ctx *ssl;
+
+void server_func(void *unused(arg))
+{
+	int i;
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_ssl_server(sched, ssl, IP_ANY, 4242);
+	XTEST(server != NULL);
+	for (i = 0; i < NBCONNS; i++) {
+		client = rinoo_ssl_accept(server, NULL, NULL);
+		XTEST(client != NULL);
+		XTEST(rinoo_socket_read(client, &b, 1) == 1);
+		XTEST(rinoo_socket_write(client, &b, 1) == 1);
+		rinoo_socket_destroy(client);
+	}
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+bool exchange(void)
+{
+	char b;
+	bool resumed;
+	t_socket *client;
+
+	client = rinoo_ssl_client(sched, ssl, IP_LOOPBACK, 4242, 1000);
+	XTEST(client != NULL);
+	resumed = SSL_session_reused(rinoo_ssl_get(client)->ssl);
+	/* Reading lets the client process tickets sent after the handshake */
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'a');
+	rinoo_socket_destroy(client);
+	return resumed;
+}
+
+void client_func(void *unused(arg))
+{
+	t_ssl_session_stats stats;
+
+	XTEST(exchange() == false);
+	XTEST(exchange() == true);
+	XTEST(exchange() == true);
+
+	/* Rotation: tickets from the previous key are accepted and renewed */
+	ssl->keys[0].created -= 3600;
+	XTEST(exchange() == true);
+	XTEST(exchange() == true);
+
+	/* Both keys expired: full handshake */
+	ssl->keys[0].created -= 2 * 3600;
+	XTEST(exchange() == false);
+
+	rinoo_ssl_context_stats(ssl, &stats);
+	rinoo_log("sessions - hits: %llu, misses: %llu, resumed: %llu, full: %llu",
+		  (unsigned long long) stats.hits, (unsigned long long) stats.misses,
+		  (unsigned long long) stats.resumed, (unsigned long long) stats.full);
+	XTEST(stats.hits == 4);
+	XTEST(stats.misses == 2);
+	XTEST(stats.resumed == 4);
+	XTEST(stats.full == 2);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ssl = rinoo_ssl_context();
+	XTEST(ssl != NULL);
+	XTEST(rinoo_ssl_context_session_cache(ssl, 128, 0) == 0);
+	XTEST(rinoo_ssl_context_tickets(ssl, 3600) == 0);
+	XTEST(rinoo_task_start(sched, server_func, NULL) == 0);
+	XTEST(rinoo_task_start(sched, client_func, NULL) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_ssl_context_destroy(ssl);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
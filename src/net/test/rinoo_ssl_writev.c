@@ -0,0 +1,130 @@
+/**
+ * @file   rinoo_ssl_writev.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 22:04:51 2026
+ *
+ * @brief  SSL gather write unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define BODY_SIZE	(RINOO_SSL_RECORD_SIZE * 2 + 1000)
+
+int checker = 0;
+int records = 0;
+t_sched *sched;
+
+void record_callback(int write_p, int version, int content_type, const void *buf, size_t len, SSL *ssl, void *arg)
+{
+	(void) arg;
+	(void) version;
+
+	/* TLS 1.3 hides the record type, check the inner one */
+	if (write_p == 0 || len < 1 || ((const unsigned char *) buf)[0] != SSL3_RT_APPLICATION_DATA) {
+		return;
+	}
+	if (content_type == SSL3_RT_INNER_CONTENT_TYPE ||
+	    (content_type == SSL3_RT_HEADER && SSL_version(ssl) != TLS1_3_VERSION)) {
+		records++;
+	}
+}
+
+void process_client(void *arg)
+{
+	int i;
+	char *body;
+	t_buffer headers[3];
+	t_buffer content;
+	t_buffer *buffers[4];
+	t_socket *socket = arg;
+
+	body = malloc(BODY_SIZE);
+	XTEST(body != NULL);
+	memset(body, 'x', BODY_SIZE);
+	buffer_static(&headers[0], "HTTP/1.1 200 OK\r\n", 17);
+	buffer_static(&headers[1], "Server: RiNOO\r\n", 15);
+	buffer_static(&headers[2], "\r\n", 2);
+	buffer_static(&content, body, BODY_SIZE);
+	for (i = 0; i < 3; i++) {
+		buffers[i] = &headers[i];
+	}
+	buffers[3] = &content;
+	SSL_set_msg_callback(rinoo_ssl_get(socket)->ssl, record_callback);
+	records = 0;
+	XTEST(rinoo_socket_writev(socket, buffers, 4) == 17 + 15 + 2 + BODY_SIZE);
+	/* Small buffers share records, no record is left partially filled */
+	XTEST(records == (17 + 15 + 2 + BODY_SIZE + RINOO_SSL_RECORD_SIZE - 1) / RINOO_SSL_RECORD_SIZE);
+	XTEST(rinoo_ssl_get(socket)->staging != NULL);
+	free(body);
+	/* Coalescing relies on writev */
+	XTEST(rinoo_socket_coalesce(socket, 1024) == 0);
+	XTEST(rinoo_socket_write(socket, "ab", 2) == 2);
+	XTEST(rinoo_socket_write(socket, "cd", 2) == 2);
+	XTEST(socket->coalesce.len == 4);
+	XTEST(rinoo_socket_flush(socket) == 0);
+	XTEST(records == (17 + 15 + 2 + BODY_SIZE + RINOO_SSL_RECORD_SIZE - 1) / RINOO_SSL_RECORD_SIZE + 1);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+void server_func(void *arg)
+{
+	t_socket *client;
+	t_socket *server;
+	t_ssl_ctx *ctx = arg;
+
+	server = rinoo_ssl_server(sched, ctx, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_ssl_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_task_start(sched, process_client, client);
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *arg)
+{
+	size_t i;
+	char *buf;
+	t_socket *client;
+	t_ssl_ctx *ctx = arg;
+
+	client = rinoo_ssl_client(sched, ctx, IP_LOOPBACK, 4242, 0);
+	XTEST(client != NULL);
+	buf = malloc(BODY_SIZE);
+	XTEST(buf != NULL);
+	XTEST(rinoo_socket_read_exact(client, buf, 34) == 34);
+	XTEST(memcmp(buf, "HTTP/1.1 200 OK\r\nServer: RiNOO\r\n\r\n", 34) == 0);
+	XTEST(rinoo_socket_read_exact(client, buf, BODY_SIZE) == BODY_SIZE);
+	for (i = 0; i < BODY_SIZE; i++) {
+		XTEST(buf[i] == 'x');
+	}
+	XTEST(rinoo_socket_read_exact(client, buf, 4) == 4);
+	XTEST(memcmp(buf, "abcd", 4) == 0);
+	free(buf);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_ssl_ctx *ssl;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	ssl = rinoo_ssl_context();
+	XTEST(ssl != NULL);
+	rinoo_task_start(sched, server_func, ssl);
+	rinoo_task_start(sched, client_func, ssl);
+	rinoo_sched_loop(sched);
+	rinoo_ssl_context_destroy(ssl);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
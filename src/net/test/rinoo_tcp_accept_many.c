@@ -0,0 +1,85 @@
+/**
+ * @file   rinoo_tcp_accept_many.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 17:20:44 2026
+ *
+ * @brief  rinoo_tcp_accept_many and listener options unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBCLIENTS	10
+#define BATCH_SIZE	4
+
+int checker = 0;
+
+void server_func(void *sched)
+{
+	int i;
+	int nb;
+	int defer;
+	char b;
+	int accepted;
+	socklen_t len;
+	t_socket *server;
+	t_socket *clients[BATCH_SIZE];
+	t_tcp_listen_options options = { .backlog = 16, .defer_accept = 1 };
+
+	server = rinoo_tcp_server_options(sched, IP_ANY, 4242, &options);
+	XTEST(server != NULL);
+	len = sizeof(defer);
+	XTEST(getsockopt(server->node.fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &defer, &len) == 0);
+	XTEST(defer > 0);
+	/* Let every client connect so that the backlog gets drained by batches */
+	rinoo_task_wait(sched, 100);
+	for (accepted = 0; accepted < NBCLIENTS; accepted += nb) {
+		nb = rinoo_tcp_accept_many(server, clients, BATCH_SIZE);
+		rinoo_log("server - accepted %d connections", nb);
+		XTEST(nb == (NBCLIENTS - accepted < BATCH_SIZE ? NBCLIENTS - accepted : BATCH_SIZE));
+		for (i = 0; i < nb; i++) {
+			/* Deferred accept: data is already there */
+			XTEST(rinoo_socket_read(clients[i], &b, 1) == 1);
+			XTEST(b == 'a');
+			rinoo_socket_destroy(clients[i]);
+		}
+	}
+	checker++;
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	t_socket *clients[NBCLIENTS];
+
+	for (i = 0; i < NBCLIENTS; i++) {
+		clients[i] = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+		XTEST(clients[i] != NULL);
+		XTEST(rinoo_socket_write(clients[i], "a", 1) == 1);
+	}
+	for (i = 0; i < NBCLIENTS; i++) {
+		rinoo_socket_destroy(clients[i]);
+	}
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
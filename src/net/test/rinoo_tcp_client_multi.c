@@ -0,0 +1,121 @@
+/**
+ * @file   rinoo_tcp_client_multi.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 21:12:06 2026
+ *
+ * @brief  rinoo_tcp_client_multi unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+int checker = 0;
+
+void set_ip(t_ip *ip, const char *addr)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->v4.sin_family = AF_INET;
+	ip->v4.sin_port = htons(4242);
+	inet_pton(AF_INET, addr, &ip->v4.sin_addr);
+}
+
+/**
+ * Creates a listener which accept queue is full, so that new SYNs get
+ * silently dropped and connection attempts hang.
+ */
+int hanging_listener(int *fds)
+{
+	int i;
+	int val;
+	t_ip ip;
+
+	set_ip(&ip, "127.0.0.3");
+	fds[0] = socket(AF_INET, SOCK_STREAM, 0);
+	val = 1;
+	if (fds[0] < 0 || setsockopt(fds[0], SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val)) != 0 ||
+	    bind(fds[0], (struct sockaddr *) &ip.v4, sizeof(ip.v4)) != 0 || listen(fds[0], 0) != 0) {
+		return -1;
+	}
+	for (i = 1; i < 3; i++) {
+		fds[i] = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+		connect(fds[i], (struct sockaddr *) &ip.v4, sizeof(ip.v4));
+	}
+	usleep(50000);
+	return 0;
+}
+
+void server_func(void *sched)
+{
+	char b;
+	t_ip ip;
+	t_socket *server;
+	t_socket *client;
+
+	set_ip(&ip, "127.0.0.1");
+	server = rinoo_tcp_server(sched, &ip, 4242);
+	XTEST(server != NULL);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'a');
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void client_func(void *sched)
+{
+	int i;
+	int fds[3];
+	t_ip ips[2];
+	uint64_t start;
+	uint64_t elapsed;
+	t_socket *client;
+
+	XTEST(hanging_listener(fds) == 0);
+	/* The first address hangs, the second one is tried after the attempt delay */
+	set_ip(&ips[0], "127.0.0.3");
+	set_ip(&ips[1], "127.0.0.1");
+	start = ((t_sched *) sched)->clock;
+	client = rinoo_tcp_client_multi(sched, ips, 2, 4242, 2000);
+	elapsed = (((t_sched *) sched)->clock - start) / RINOO_NSEC_PER_MSEC;
+	rinoo_log("client - connected after %llu ms", (unsigned long long) elapsed);
+	XTEST(client != NULL);
+	XTEST(elapsed >= RINOO_TCP_ATTEMPT_DELAY - 10 && elapsed < 1000);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	rinoo_socket_destroy(client);
+
+	/* Refused attempts are replaced at once and the last error is reported */
+	set_ip(&ips[0], "127.0.0.2");
+	set_ip(&ips[1], "127.0.0.4");
+	start = ((t_sched *) sched)->clock;
+	client = rinoo_tcp_client_multi(sched, ips, 2, 4242, 2000);
+	elapsed = (((t_sched *) sched)->clock - start) / RINOO_NSEC_PER_MSEC;
+	XTEST(client == NULL);
+	XTEST(errno == ECONNREFUSED);
+	XTEST(elapsed < RINOO_TCP_ATTEMPT_DELAY);
+	for (i = 0; i < 3; i++) {
+		close(fds[i]);
+	}
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
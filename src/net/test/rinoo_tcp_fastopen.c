@@ -0,0 +1,110 @@
+/**
+ * @file   rinoo_tcp_fastopen.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Mon Oct 19 02:14:06 2026
+ *
+ * @brief  TCP Fast Open unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBCONNS	3
+
+int checker = 0;
+
+void server_func(void *sched)
+{
+	int i;
+	int qlen;
+	char b;
+	socklen_t len;
+	t_socket *server;
+	t_socket *client;
+	t_tcp_listen_options options = { .backlog = 0, .defer_accept = 0, .fastopen = 16 };
+
+	server = rinoo_tcp_server_options(sched, IP_ANY, 4242, &options);
+	XTEST(server != NULL);
+	len = sizeof(qlen);
+	XTEST(getsockopt(server->node.fd, IPPROTO_TCP, TCP_FASTOPEN, &qlen, &len) == 0);
+	XTEST(qlen == 16);
+	for (i = 0; i < NBCONNS; i++) {
+		client = rinoo_tcp_accept(server, NULL, NULL);
+		XTEST(client != NULL);
+		XTEST(rinoo_socket_read(client, &b, 1) == 1);
+		XTEST(rinoo_socket_write(client, &b, 1) == 1);
+		rinoo_socket_destroy(client);
+	}
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+bool fastopen_enabled(void)
+{
+	int fd;
+	char buf[16];
+	ssize_t len;
+
+	/* Client (1) and server (2) support */
+	fd = open("/proc/sys/net/ipv4/tcp_fastopen", O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (len <= 0) {
+		return false;
+	}
+	buf[len] = 0;
+	return ((atoi(buf) & 3) == 3);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	char b;
+	bool syn_data;
+	socklen_t len;
+	t_socket *client;
+	struct tcp_info info;
+
+	syn_data = false;
+	for (i = 0; i < NBCONNS; i++) {
+		client = rinoo_tcp_client_fastopen(sched, IP_LOOPBACK, 4242, 1000);
+		XTEST(client != NULL);
+		/* Fast Open clients write first */
+		XTEST(rinoo_socket_write(client, "a", 1) == 1);
+		XTEST(rinoo_socket_read(client, &b, 1) == 1);
+		XTEST(b == 'a');
+		len = sizeof(info);
+		XTEST(getsockopt(client->node.fd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0);
+		syn_data = ((info.tcpi_options & TCPI_OPT_SYN_DATA) != 0);
+		rinoo_log("client - connection %d, data in SYN: %s", i, (syn_data ? "yes" : "no"));
+		rinoo_socket_destroy(client);
+	}
+	/* Cookie obtained by the first connection is used by the next ones */
+	if (fastopen_enabled()) {
+		XTEST(syn_data);
+	}
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
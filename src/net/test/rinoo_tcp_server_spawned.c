@@ -0,0 +1,82 @@
+/**
+ * @file   rinoo_tcp_server_spawned.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 16:52:03 2026
+ *
+ * @brief  rinoo_tcp_server_spawned unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBSPAWNS	4
+#define NBCLIENTS	50
+
+t_tcp_spawned *server;
+
+void process_client(void *socket)
+{
+	char b;
+
+	XTEST(rinoo_socket_write(socket, "x", 1) == 1);
+	XTEST(rinoo_socket_read(socket, &b, 1) == -1);
+	rinoo_socket_destroy(socket);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	char a;
+	t_socket *client;
+
+	for (i = 0; i < NBCLIENTS; i++) {
+		client = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 1000);
+		XTEST(client != NULL);
+		XTEST(rinoo_socket_read(client, &a, 1) == 1);
+		XTEST(a == 'x');
+		rinoo_socket_destroy(client);
+	}
+	/* Let every spawn reach its loop before stopping them */
+	rinoo_task_wait(sched, 200);
+	rinoo_sched_stop(sched);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	int i;
+	uint64_t total;
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_spawn(sched, NBSPAWNS) == 0);
+	server = rinoo_tcp_server_spawned(sched, IP_ANY, 4242, process_client);
+	XTEST(server != NULL);
+	XTEST(server->count == NBSPAWNS + 1);
+	for (i = 0; i < server->count; i++) {
+		XTEST(server->listeners[i].sched == rinoo_spawn_get(sched, i));
+		XTEST(server->listeners[i].id == i);
+	}
+	if (sysconf(_SC_NPROCESSORS_ONLN) == server->count) {
+		XTEST(rinoo_tcp_server_spawned_steer(server) == 0);
+	} else {
+		/* Steering needs one scheduler per CPU */
+		XTEST(rinoo_tcp_server_spawned_steer(server) == -1 && errno == EINVAL);
+	}
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_tcp_server_spawned_report(server);
+	for (i = 0, total = 0; i < server->count; i++) {
+		total += server->listeners[i].accepted;
+	}
+	XTEST(total == NBCLIENTS);
+	rinoo_sched_destroy(sched);
+	rinoo_tcp_server_spawned_destroy(server);
+	XPASS();
+}
@@ -0,0 +1,97 @@
+/**
+ * @file   rinoo_udp_gso.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 16:24:50 2026
+ *
+ * @brief  UDP GSO/GRO unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NB_DATAGRAMS	40
+#define DATAGRAM_SIZE	1000
+#define LAST_SIZE	500
+#define TOTAL_SIZE	(NB_DATAGRAMS * DATAGRAM_SIZE + LAST_SIZE)
+
+extern const t_socket_class socket_class_udp;
+
+int checker = 0;
+
+void server_func(void *sched)
+{
+	unsigned int i;
+	size_t total;
+	ssize_t ret;
+	uint16_t segsize;
+	unsigned int index;
+	t_buffer view;
+	t_buffer *buffer;
+	t_socket *server;
+	struct sockaddr_in addr;
+
+	server = rinoo_socket(sched, &socket_class_udp);
+	XTEST(server != NULL);
+	addr.sin_port = htons(4242);
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	XTEST(rinoo_socket_bind(server, (struct sockaddr *) &addr, sizeof(addr), 0) == 0);
+	XTEST(rinoo_udp_gro(server, true) == 0);
+	buffer = buffer_create(NULL);
+	XTEST(buffer != NULL);
+	XTEST(buffer_extend(buffer, RINOO_UDP_GRO_BUFFER_SIZE) == 0);
+	index = 0;
+	for (total = 0; total < TOTAL_SIZE; total += ret) {
+		ret = rinoo_udp_recvgro(server, buffer, &segsize, NULL, NULL);
+		XTEST(ret > 0);
+		rinoo_log("server - received %zd bytes, datagram size %u", ret, segsize);
+		for (i = 0; rinoo_udp_segment(buffer, segsize, i, &view) == 0; i++, index++) {
+			XTEST(buffer_size(&view) == (index < NB_DATAGRAMS ? DATAGRAM_SIZE : LAST_SIZE));
+			XTEST(((unsigned char *) buffer_ptr(&view))[0] == index);
+			XTEST(((unsigned char *) buffer_ptr(&view))[buffer_size(&view) - 1] == index);
+		}
+	}
+	XTEST(index == NB_DATAGRAMS + 1);
+	buffer_destroy(buffer);
+	checker++;
+	rinoo_socket_destroy(server);
+}
+
+void client_func(void *sched)
+{
+	int i;
+	char *data;
+	t_socket *client;
+
+	data = malloc(TOTAL_SIZE);
+	XTEST(data != NULL);
+	for (i = 0; i <= NB_DATAGRAMS; i++) {
+		memset(data + i * DATAGRAM_SIZE, i, (i < NB_DATAGRAMS ? DATAGRAM_SIZE : LAST_SIZE));
+	}
+	client = rinoo_udp_client(sched, IP_LOOPBACK, 4242);
+	XTEST(client != NULL);
+	XTEST(rinoo_udp_sendgso(client, data, TOTAL_SIZE, DATAGRAM_SIZE, NULL, 0) == TOTAL_SIZE);
+	free(data);
+	checker++;
+	rinoo_socket_destroy(client);
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file   rinoo_unix.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 20:41:53 2026
+ *
+ * @brief  Unix domain sockets unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define STREAM_PATH	"/tmp/rinoo_unix_test.sock"
+#define ABSTRACT_PATH	"@rinoo_unix_test"
+#define DGRAM_PATH	"@rinoo_unix_dgram_test"
+
+int checker = 0;
+
+/**
+ * Leaves a socket file without server behind.
+ */
+int stale_file(void)
+{
+	int fd;
+	struct sockaddr_un addr;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, STREAM_PATH);
+	unlink(STREAM_PATH);
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+void stream_server_func(void *sched)
+{
+	int fd;
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	XTEST(stale_file() == 0);
+	server = rinoo_unix_server(sched, STREAM_PATH);
+	XTEST(server != NULL);
+	client = rinoo_unix_accept(server);
+	XTEST(client != NULL);
+	/* The path belongs to a live server */
+	XTEST(rinoo_unix_server(sched, STREAM_PATH) == NULL);
+	XTEST(errno == EADDRINUSE);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'a');
+	XTEST(rinoo_socket_write(client, "b", 1) == 1);
+	/* Coalesced data goes before the descriptors */
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'x');
+	/* Read-ahead would drop descriptors */
+	XTEST(rinoo_socket_readahead(client, 64) == 0);
+	XTEST(rinoo_unix_recvfds(client, &fd, 1) == -1);
+	XTEST(errno == EINVAL);
+	XTEST(rinoo_socket_readahead(client, 0) == 0);
+	/* Passed descriptor is the write end of a pipe */
+	XTEST(rinoo_unix_recvfds(client, &fd, 1) == 1);
+	XTEST(write(fd, "c", 1) == 1);
+	close(fd);
+	XTEST(rinoo_socket_write(client, "e", 1) == 1);
+	/* More descriptors than expected: none is handed over */
+	XTEST(rinoo_unix_recvfds(client, &fd, 1) == -1);
+	XTEST(errno == EMSGSIZE);
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void abstract_server_func(void *sched)
+{
+	char b;
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_unix_server(sched, ABSTRACT_PATH);
+	XTEST(server != NULL);
+	client = rinoo_unix_accept(server);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(rinoo_socket_write(client, &b, 1) == 1);
+	rinoo_socket_destroy(client);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void dgram_server_func(void *sched)
+{
+	char buf[16];
+	socklen_t addrlen;
+	t_socket *server;
+	struct sockaddr_un addr;
+
+	server = rinoo_unix_dgram_server(sched, DGRAM_PATH);
+	XTEST(server != NULL);
+	addrlen = sizeof(addr);
+	XTEST(rinoo_socket_recvfrom(server, buf, sizeof(buf), (struct sockaddr *) &addr, &addrlen) == 5);
+	XTEST(memcmp(buf, "hello", 5) == 0);
+	XTEST(rinoo_socket_sendto(server, "world", 5, (struct sockaddr *) &addr, addrlen) == 5);
+	rinoo_socket_destroy(server);
+	checker++;
+}
+
+void client_func(void *sched)
+{
+	int fds[2];
+	char b;
+	char buf[16];
+	t_socket *client;
+
+	client = rinoo_unix_client(sched, STREAM_PATH, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_write(client, "a", 1) == 1);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'b');
+	XTEST(pipe(fds) == 0);
+	XTEST(rinoo_socket_coalesce(client, 64) == 0);
+	XTEST(rinoo_socket_write(client, "x", 1) == 1);
+	XTEST(rinoo_unix_sendfds(client, &fds[1], 1) == 0);
+	close(fds[1]);
+	/* Pipe is blocking, only read it once the server wrote to it */
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'e');
+	XTEST(read(fds[0], &b, 1) == 1);
+	XTEST(b == 'c');
+	close(fds[0]);
+	XTEST(pipe(fds) == 0);
+	XTEST(rinoo_unix_sendfds(client, fds, 2) == 0);
+	close(fds[0]);
+	close(fds[1]);
+	rinoo_socket_destroy(client);
+
+	client = rinoo_unix_client(sched, ABSTRACT_PATH, 1000);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_write(client, "d", 1) == 1);
+	XTEST(rinoo_socket_read(client, &b, 1) == 1);
+	XTEST(b == 'd');
+	rinoo_socket_destroy(client);
+
+	client = rinoo_unix_dgram_client(sched, DGRAM_PATH);
+	XTEST(client != NULL);
+	XTEST(rinoo_socket_write(client, "hello", 5) == 5);
+	XTEST(rinoo_socket_read(client, buf, sizeof(buf)) == 5);
+	XTEST(memcmp(buf, "world", 5) == 0);
+	rinoo_socket_destroy(client);
+	checker++;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, stream_server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, abstract_server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, dgram_server_func, sched) == 0);
+	XTEST(rinoo_task_start(sched, client_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	unlink(STREAM_PATH);
+	XTEST(checker == 4);
+	XPASS();
+}
@@ -45,3 +45,230 @@ t_socket *rinoo_udp_client(t_sched *sched, t_ip *ip, uint16_t port)
 	}
 	return socket;
 }
+
+/**
+ * Sends a chunk of same-size datagrams with a single UDP_SEGMENT send.
+ *
+ * @param socket Pointer to the socket to use
+ * @param buf Datagrams to send
+ * @param count Chunk size
+ * @param segsize Size of each datagram
+ * @param addrto Destination address or NULL on connected sockets
+ * @param addrlen Destination address length
+ *
+ * @return The number of bytes sent on success or -1 if an error occurs
+ */
+static ssize_t rinoo_udp_sendgso_chunk(t_socket *socket, const void *buf, size_t count, uint16_t segsize, const struct sockaddr *addrto, socklen_t addrlen)
+{
+	ssize_t ret;
+	struct iovec iov;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	char control[CMSG_SPACE(sizeof(uint16_t))];
+
+	iov.iov_base = (void *) buf;
+	iov.iov_len = count;
+	memset(&msg, 0, sizeof(msg));
+	memset(control, 0, sizeof(control));
+	msg.msg_name = (void *) addrto;
+	msg.msg_namelen = addrlen;
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_UDP;
+	cmsg->cmsg_type = UDP_SEGMENT;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+	memcpy(CMSG_DATA(cmsg), &segsize, sizeof(segsize));
+	while (1) {
+		if (rinoo_socket_waitio(socket) != 0) {
+			return -1;
+		}
+		errno = 0;
+		ret = sendmsg(socket->node.fd, &msg, MSG_DONTWAIT);
+		if (ret >= 0) {
+			return ret;
+		}
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_socket_waitout(socket) != 0) {
+			return -1;
+		}
+	}
+}
+
+/**
+ * Sends count bytes as datagrams of segsize bytes (the last one can be
+ * shorter) using UDP generic segmentation offload. The kernel splits each
+ * send into datagrams, so up to RINOO_UDP_GSO_MAX_SEGMENTS datagrams cost
+ * a single syscall. Falls back to one send per datagram when the route
+ * does not support segmentation offload.
+ *
+ * @param socket Pointer to the UDP socket to use
+ * @param buf Datagrams to send, stored contiguously
+ * @param count Total size to send
+ * @param segsize Size of each datagram
+ * @param addrto Destination address or NULL on connected sockets
+ * @param addrlen Destination address length
+ *
+ * @return count on success or -1 if an error occurs
+ */
+ssize_t rinoo_udp_sendgso(t_socket *socket, const void *buf, size_t count, uint16_t segsize, const struct sockaddr *addrto, socklen_t addrlen)
+{
+	size_t len;
+	size_t sent;
+	size_t chunk;
+	ssize_t ret;
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->type == SOCK_DGRAM, -1);
+	XASSERT(segsize > 0, -1);
+
+	chunk = RINOO_UDP_GSO_MAX_SIZE / segsize;
+	if (chunk > RINOO_UDP_GSO_MAX_SEGMENTS) {
+		chunk = RINOO_UDP_GSO_MAX_SEGMENTS;
+	}
+	chunk *= segsize;
+	for (sent = 0; sent < count; sent += len) {
+		len = count - sent;
+		if (len > chunk) {
+			len = chunk;
+		}
+		if (chunk > 0) {
+			ret = rinoo_udp_sendgso_chunk(socket, buf + sent, len, segsize, addrto, addrlen);
+			if (ret >= 0) {
+				continue;
+			}
+			if (errno != EIO && errno != EOPNOTSUPP) {
+				return -1;
+			}
+			/* No checksum offload on this route, stop trying */
+			chunk = 0;
+		}
+		len = (count - sent > segsize ? segsize : count - sent);
+		if (socket->class->sendto(socket, (void *) buf + sent, len, addrto, addrlen) < 0) {
+			return -1;
+		}
+	}
+	return count;
+}
+
+/**
+ * Enables or disables UDP generic receive offload on a socket.
+ * When enabled, same-size datagrams from a peer can be received
+ * coalesced with rinoo_udp_recvgro.
+ *
+ * @param socket Pointer to the UDP socket to use
+ * @param enabled Whether GRO should be enabled
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_udp_gro(t_socket *socket, bool enabled)
+{
+	int value;
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->type == SOCK_DGRAM, -1);
+
+	value = (enabled ? 1 : 0);
+	return setsockopt(socket->node.fd, SOL_UDP, UDP_GRO, &value, sizeof(value));
+}
+
+/**
+ * Receives one possibly coalesced GRO datagram. The buffer content is
+ * replaced and segsize is set to the size of each original datagram,
+ * use rinoo_udp_segment to get them. A buffer of RINOO_UDP_GRO_BUFFER_SIZE
+ * bytes never truncates coalesced datagrams.
+ *
+ * @param socket Pointer to the UDP socket to read
+ * @param buffer Buffer where to store received data
+ * @param segsize Pointer where to store the datagram size
+ * @param addrfrom Sockaddr where to store the source address, can be NULL
+ * @param addrlen Socklen where to store the size of the source address, can be NULL
+ *
+ * @return The number of bytes received on success or -1 if an error occurs
+ */
+ssize_t rinoo_udp_recvgro(t_socket *socket, t_buffer *buffer, uint16_t *segsize, struct sockaddr *addrfrom, socklen_t *addrlen)
+{
+	int gso;
+	ssize_t ret;
+	struct iovec iov;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	char control[CMSG_SPACE(sizeof(int))];
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(buffer != NULL, -1);
+	XASSERT(segsize != NULL, -1);
+
+	if (rinoo_socket_waitio(socket) != 0) {
+		return -1;
+	}
+	while (1) {
+		iov.iov_base = buffer_ptr(buffer);
+		iov.iov_len = buffer_msize(buffer);
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_name = addrfrom;
+		msg.msg_namelen = (addrlen != NULL ? *addrlen : 0);
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		errno = 0;
+		ret = recvmsg(socket->node.fd, &msg, MSG_DONTWAIT);
+		if (ret >= 0) {
+			break;
+		}
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_socket_waitin(socket) != 0) {
+			return -1;
+		}
+	}
+	if (addrlen != NULL) {
+		*addrlen = msg.msg_namelen;
+	}
+	buffer_setsize(buffer, ret);
+	*segsize = ret;
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+			memcpy(&gso, CMSG_DATA(cmsg), sizeof(gso));
+			*segsize = gso;
+		}
+	}
+	return ret;
+}
+
+/**
+ * Gets a view on one datagram of a buffer filled by rinoo_udp_recvgro.
+ * The view points into buffer, no data is copied.
+ *
+ * @param buffer Buffer filled by rinoo_udp_recvgro
+ * @param segsize Datagram size returned by rinoo_udp_recvgro
+ * @param index Datagram index
+ * @param view Buffer to set as a view on the datagram
+ *
+ * @return 0 on success or -1 if index is out of the buffer
+ */
+int rinoo_udp_segment(t_buffer *buffer, uint16_t segsize, unsigned int index, t_buffer *view)
+{
+	size_t size;
+	size_t offset;
+
+	XASSERT(buffer != NULL, -1);
+	XASSERT(view != NULL, -1);
+
+	offset = (size_t) index * segsize;
+	if (segsize == 0 || offset >= buffer_size(buffer)) {
+		return -1;
+	}
+	size = buffer_size(buffer) - offset;
+	if (size > segsize) {
+		size = segsize;
+	}
+	buffer_static(view, buffer_ptr(buffer) + offset, size);
+	return 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file   unix.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 20:25:19 2026
+ *
+ * @brief  Unix domain socket management
+ *
+ *
+ */
+
+#include "rinoo/net/module.h"
+
+extern const t_socket_class socket_class_unix;
+extern const t_socket_class socket_class_unix_dgram;
+
+/**
+ * Fills a unix socket address from a path.
+ * A leading '@' selects the abstract namespace.
+ *
+ * @param addr Pointer to the address to fill
+ * @param path Socket path
+ *
+ * @return Address length on success or 0 if the path is invalid
+ */
+static socklen_t rinoo_unix_addr(struct sockaddr_un *addr, const char *path)
+{
+	size_t len;
+
+	len = strlen(path);
+	if (len == 0 || len >= sizeof(addr->sun_path)) {
+		errno = EINVAL;
+		return 0;
+	}
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	memcpy(addr->sun_path, path, len);
+	if (path[0] == '@') {
+		/* Abstract names are not NUL terminated */
+		addr->sun_path[0] = 0;
+		return offsetof(struct sockaddr_un, sun_path) + len;
+	}
+	return offsetof(struct sockaddr_un, sun_path) + len + 1;
+}
+
+/**
+ * Removes a socket file left by a previous server.
+ * The file is only removed when nothing answers on it. A live stream
+ * server sees the probe as a connection closed right away.
+ *
+ * @param class Socket class to use
+ * @param addr Socket address
+ * @param addr_len Address length
+ *
+ * @return 0 on success or -1 if a server uses the path (EADDRINUSE)
+ */
+static int rinoo_unix_stale(const t_socket_class *class, const struct sockaddr_un *addr, socklen_t addr_len)
+{
+	int fd;
+	int ret;
+	struct stat st;
+
+	if (stat(addr->sun_path, &st) != 0 || !S_ISSOCK(st.st_mode)) {
+		return 0;
+	}
+	fd = socket(AF_UNIX, class->type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	ret = connect(fd, (const struct sockaddr *) addr, addr_len);
+	if (ret == 0 || errno == EAGAIN) {
+		close(fd);
+		errno = EADDRINUSE;
+		return -1;
+	}
+	if (errno == ECONNREFUSED) {
+		unlink(addr->sun_path);
+	}
+	close(fd);
+	return 0;
+}
+
+/**
+ * Creates a unix socket bound to a path.
+ * A stale socket file left by a previous server is removed first,
+ * a path used by a running server is refused.
+ *
+ * @param sched Scheduler pointer
+ * @param class Socket class to use
+ * @param path Path to bind
+ * @param backlog Listening queue size, ignored by datagram sockets
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+static t_socket *rinoo_unix_bound(t_sched *sched, const t_socket_class *class, const char *path, int backlog)
+{
+	t_socket *socket;
+	socklen_t addr_len;
+	struct sockaddr_un addr;
+
+	addr_len = rinoo_unix_addr(&addr, path);
+	if (addr_len == 0) {
+		return NULL;
+	}
+	if (path[0] != '@' && rinoo_unix_stale(class, &addr, addr_len) != 0) {
+		return NULL;
+	}
+	socket = rinoo_socket(sched, class);
+	if (unlikely(socket == NULL)) {
+		return NULL;
+	}
+	if (rinoo_socket_bind(socket, (struct sockaddr *) &addr, addr_len, backlog) != 0) {
+		rinoo_socket_destroy(socket);
+		return NULL;
+	}
+	return socket;
+}
+
+/**
+ * Creates a unix stream client connected to a path.
+ *
+ * @param sched Scheduler pointer
+ * @param path Socket path to connect to
+ * @param timeout Socket timeout
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_unix_client(t_sched *sched, const char *path, uint32_t timeout)
+{
+	t_socket *socket;
+	socklen_t addr_len;
+	struct sockaddr_un addr;
+
+	XASSERT(path != NULL, NULL);
+
+	addr_len = rinoo_unix_addr(&addr, path);
+	if (addr_len == 0) {
+		return NULL;
+	}
+	socket = rinoo_socket(sched, &socket_class_unix);
+	if (unlikely(socket == NULL)) {
+		return NULL;
+	}
+	if (timeout != 0 && rinoo_socket_timeout(socket, timeout) != 0) {
+		rinoo_socket_destroy(socket);
+		return NULL;
+	}
+	if (rinoo_socket_connect(socket, (struct sockaddr *) &addr, addr_len) != 0) {
+		rinoo_socket_destroy(socket);
+		return NULL;
+	}
+	return socket;
+}
+
+/**
+ * Creates a unix stream server listening on a path.
+ *
+ * @param sched Scheduler pointer
+ * @param path Socket path to bind
+ *
+ * @return Socket pointer to the server on success or NULL if an error occurs
+ */
+t_socket *rinoo_unix_server(t_sched *sched, const char *path)
+{
+	XASSERT(path != NULL, NULL);
+
+	return rinoo_unix_bound(sched, &socket_class_unix, path, RINOO_UNIX_BACKLOG);
+}
+
+/**
+ * Accepts a new connection from a listening unix socket.
+ *
+ * @param socket Pointer to the socket which is listening to
+ *
+ * @return A pointer to the new socket on success or NULL if an error occurs
+ */
+t_socket *rinoo_unix_accept(t_socket *socket)
+{
+	return rinoo_socket_accept(socket, NULL, NULL);
+}
+
+/**
+ * Creates a unix datagram client connected to a path.
+ * The socket is bound to an automatic abstract name so that it can get replies.
+ *
+ * @param sched Scheduler pointer
+ * @param path Socket path to connect to
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_unix_dgram_client(t_sched *sched, const char *path)
+{
+	t_socket *socket;
+	socklen_t addr_len;
+	struct sockaddr_un addr;
+
+	XASSERT(path != NULL, NULL);
+
+	addr_len = rinoo_unix_addr(&addr, path);
+	if (addr_len == 0) {
+		return NULL;
+	}
+	socket = rinoo_socket(sched, &socket_class_unix_dgram);
+	if (unlikely(socket == NULL)) {
+		return NULL;
+	}
+	/* Binding with only the address family triggers autobind */
+	if (rinoo_socket_bind(socket, (struct sockaddr *) &addr, sizeof(sa_family_t), 0) != 0 ||
+	    rinoo_socket_connect(socket, (struct sockaddr *) &addr, addr_len) != 0) {
+		rinoo_socket_destroy(socket);
+		return NULL;
+	}
+	return socket;
+}
+
+/**
+ * Creates a unix datagram socket bound to a path.
+ *
+ * @param sched Scheduler pointer
+ * @param path Socket path to bind
+ *
+ * @return Socket pointer on success or NULL if an error occurs
+ */
+t_socket *rinoo_unix_dgram_server(t_sched *sched, const char *path)
+{
+	XASSERT(path != NULL, NULL);
+
+	return rinoo_unix_bound(sched, &socket_class_unix_dgram, path, 0);
+}
+
+/**
+ * Sends file descriptors through a unix socket (SCM_RIGHTS).
+ * One data byte carries the descriptors, the peer must receive them
+ * with rinoo_unix_recvfds at the same point of the stream. Coalesced
+ * data is sent first.
+ *
+ * @param socket Pointer to the unix socket to use
+ * @param fds File descriptors to send
+ * @param count Number of file descriptors, up to RINOO_UNIX_FDS_MAX
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_unix_sendfds(t_socket *socket, const int *fds, int count)
+{
+	char byte;
+	ssize_t ret;
+	struct iovec iov;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	char control[CMSG_SPACE(sizeof(int) * RINOO_UNIX_FDS_MAX)];
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->domain == AF_UNIX, -1);
+	XASSERT(count > 0 && count <= RINOO_UNIX_FDS_MAX, -1);
+
+	byte = 0;
+	iov.iov_base = &byte;
+	iov.iov_len = sizeof(byte);
+	memset(&msg, 0, sizeof(msg));
+	memset(control, 0, sizeof(control));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+	memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+	if (socket->coalesce.len > 0 && rinoo_socket_flush(socket) != 0) {
+		return -1;
+	}
+	if (rinoo_socket_waitio(socket) != 0) {
+		return -1;
+	}
+	errno = 0;
+	while ((ret = sendmsg(socket->node.fd, &msg, MSG_NOSIGNAL)) < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_socket_waitout(socket) != 0) {
+			return -1;
+		}
+		errno = 0;
+	}
+	return 0;
+}
+
+/**
+ * Receives file descriptors sent with rinoo_unix_sendfds.
+ * Received descriptors are close-on-exec. If more descriptors than count
+ * were sent, or if some got truncated, every received descriptor is
+ * closed and EMSGSIZE is reported.
+ * Read-ahead must be disabled on the socket (EINVAL otherwise): reading
+ * the data byte with read(2) would drop its descriptors.
+ *
+ * @param socket Pointer to the unix socket to use
+ * @param fds Array where to store the received file descriptors
+ * @param count Array size
+ *
+ * @return The number of file descriptors received or -1 if an error occurs
+ */
+int rinoo_unix_recvfds(t_socket *socket, int *fds, int count)
+{
+	int i;
+	int nbfds;
+	char byte;
+	bool truncated;
+	ssize_t ret;
+	struct iovec iov;
+	struct msghdr msg;
+	struct cmsghdr *cmsg;
+	char control[CMSG_SPACE(sizeof(int) * RINOO_UNIX_FDS_MAX)];
+
+	XASSERT(socket != NULL, -1);
+	XASSERT(socket->class->domain == AF_UNIX, -1);
+	XASSERT(count > 0, -1);
+
+	if (socket->readahead.size > 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	iov.iov_base = &byte;
+	iov.iov_len = sizeof(byte);
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	if (rinoo_socket_waitio(socket) != 0) {
+		return -1;
+	}
+	errno = 0;
+	while ((ret = recvmsg(socket->node.fd, &msg, MSG_CMSG_CLOEXEC)) < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_socket_waitin(socket) != 0) {
+			return -1;
+		}
+		errno = 0;
+	}
+	if (ret == 0) {
+		return -1;
+	}
+	nbfds = 0;
+	truncated = ((msg.msg_flags & MSG_CTRUNC) != 0);
+	for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+			continue;
+		}
+		for (i = 0; i < (int) ((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int)); i++) {
+			if (nbfds < count) {
+				memcpy(&fds[nbfds++], CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+			} else {
+				close(*(int *) (CMSG_DATA(cmsg) + i * sizeof(int)));
+				truncated = true;
+			}
+		}
+	}
+	if (truncated) {
+		/* Descriptors have been lost, none of them is handed over */
+		for (i = 0; i < nbfds; i++) {
+			close(fds[i]);
+		}
+		errno = EMSGSIZE;
+		return -1;
+	}
+	return nbfds;
+}
@@ -39,6 +39,43 @@ void rinoo_channel_destroy(t_channel *channel)
 	free(channel);
 }
 
+/**
+ * Waits for a writer to put something in a channel.
+ *
+ * @param channel Channel to wait for.
+ *
+ * @return 0 on success, or -1 if an error occurs (deadline is considered as an error).
+ */
+static int rinoo_channel_waitbuf(t_channel *channel)
+{
+	t_task *self;
+
+	self = rinoo_task_self();
+	/* Flushing may park this task: done before other tasks can wake it up */
+	rinoo_task_flush(self);
+	if (rinoo_task_deadline_check(self) != 0) {
+		return -1;
+	}
+	channel->task = self;
+	if (rinoo_task_release(channel->sched) != 0 || channel->buf == NULL) {
+		if (channel->task == self) {
+			channel->task = NULL;
+		}
+		if (errno != ECANCELED) {
+			errno = ETIMEDOUT;
+		}
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Get a pointer from a channel. This is blocking.
+ *
+ * @param channel Channel to read.
+ *
+ * @return Pointer put by a writer, or NULL if an error occurs.
+ */
 void *rinoo_channel_get(t_channel *channel)
 {
 	void *result;
@@ -49,12 +86,8 @@ void *rinoo_channel_get(t_channel *channel)
 	if (channel->sched != sched) {
 		return NULL;
 	}
-	if (channel->buf == NULL) {
-		channel->task = rinoo_task_self();
-		rinoo_task_release(sched);
-		if (channel->buf == NULL) {
-			return NULL;
-		}
+	if (channel->buf == NULL && rinoo_channel_waitbuf(channel) != 0) {
+		return NULL;
 	}
 	result = channel->buf;
 	task = channel->task;
@@ -91,12 +124,8 @@ int rinoo_channel_read(t_channel *channel, void *dest, size_t size)
 	if (channel->sched != sched) {
 		return -1;
 	}
-	if (channel->buf == NULL) {
-		channel->task = rinoo_task_self();
-		rinoo_task_release(sched);
-		if (channel->buf == NULL) {
-			return -1;
-		}
+	if (channel->buf == NULL && rinoo_channel_waitbuf(channel) != 0) {
+		return -1;
 	}
 	if (size > channel->size) {
 		size = channel->size;
@@ -126,6 +155,8 @@ int rinoo_channel_read(t_channel *channel, void *dest, size_t size)
  */
 int rinoo_channel_write(t_channel *channel, void *buf, size_t size)
 {
+	int ret;
+	t_task *self;
 	t_task *task;
 	t_sched *sched;
 
@@ -133,13 +164,27 @@ int rinoo_channel_write(t_channel *channel, void *buf, size_t size)
 	if (channel->sched != sched) {
 		return -1;
 	}
+	self = rinoo_task_self();
+	/* Flushing may park this task: done before other tasks can wake it up */
+	rinoo_task_flush(self);
+	if (rinoo_task_deadline_check(self) != 0) {
+		return -1;
+	}
 	channel->buf = buf;
 	channel->size = size;
 	task = channel->task;
 	if (task != NULL) {
 		rinoo_task_schedule(task, NULL);
 	}
-	channel->task = rinoo_task_self();
-	rinoo_task_release(sched);
+	channel->task = self;
+	ret = rinoo_task_release(sched);
+	if (channel->task == self && self->deadline != 0) {
+		/* Nobody took the buffer before the deadline */
+		channel->buf = NULL;
+		channel->size = 0;
+		channel->task = NULL;
+		errno = (ret != 0 ? ECANCELED : ETIMEDOUT);
+		return -1;
+	}
 	return size;
 }
@@ -10,6 +10,17 @@
 
 #include "rinoo/scheduler/module.h"
 
+static pthread_once_t sigpipe_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Ignores SIGPIPE for the whole process, writes to closed sockets
+ * then fail with EPIPE.
+ */
+static void rinoo_epoll_sigpipe(void)
+{
+	sigaction(SIGPIPE, &(struct sigaction){ .sa_handler = SIG_IGN }, NULL);
+}
+
 /**
  * Epoll initialization. It calls epoll_create and
  * initializes internal structures.
@@ -25,7 +36,7 @@ int rinoo_epoll_init(t_sched *sched)
 	sched->epoll.fd = epoll_create(42); /* Size does not matter any more ;) */
 	XASSERT(sched->epoll.fd != -1, -1);
 	sched->epoll.curevent = -1;
-	if (sigaction(SIGPIPE, &(struct sigaction){ .sa_handler = SIG_IGN }, NULL) != 0) {
+	if (pthread_once(&sigpipe_once, rinoo_epoll_sigpipe) != 0) {
 		close(sched->epoll.fd);
 		return -1;
 	}
@@ -117,27 +128,97 @@ int rinoo_epoll_remove(t_sched_node *node)
 }
 
 /**
- * Start polling. It calls epoll_wait.
+ * Waits for events. It calls epoll_pwait2 when available so timeouts
+ * keep nanosecond precision, otherwise epoll_wait with a timeout
+ * rounded up to the next millisecond.
  *
  * @param sched Pointer to the scheduler to use.
- * @param timeout Maximum time to wait in milliseconds (-1 for no timeout)
+ * @param timeout Maximum time to wait in nanoseconds (-1 for no timeout)
+ *
+ * @return Number of events received, or -1 if an error occurs.
+ */
+static int rinoo_epoll_wait(t_sched *sched, int64_t timeout)
+{
+	int ms;
+
+#ifdef RINOO_HAS_EPOLL_PWAIT2
+	static bool nopwait2 = false;
+	int nbevents;
+	struct timespec ts;
+
+	if (likely(!nopwait2)) {
+		ts.tv_sec = timeout / RINOO_NSEC_PER_SEC;
+		ts.tv_nsec = timeout % RINOO_NSEC_PER_SEC;
+		nbevents = epoll_pwait2(sched->epoll.fd, sched->epoll.events, RINOO_EPOLL_MAX_EVENTS, (timeout < 0 ? NULL : &ts), NULL);
+		if (likely(nbevents != -1 || errno != ENOSYS)) {
+			return nbevents;
+		}
+		/* Kernel is older than the C library */
+		nopwait2 = true;
+	}
+#endif /* !RINOO_HAS_EPOLL_PWAIT2 */
+
+	if (timeout < 0) {
+		ms = -1;
+	} else if (timeout >= (int64_t) INT_MAX * (int64_t) RINOO_NSEC_PER_MSEC) {
+		ms = INT_MAX;
+	} else {
+		ms = (timeout + RINOO_NSEC_PER_MSEC - 1) / RINOO_NSEC_PER_MSEC;
+	}
+	return epoll_wait(sched->epoll.fd, sched->epoll.events, RINOO_EPOLL_MAX_EVENTS, ms);
+}
+
+/**
+ * Handles EPOLLERR on a node which receives error queue notifications
+ * (like MSG_ZEROCOPY completions). Only a pending socket error is
+ * considered as an error, otherwise the node is woken up in
+ * RINOO_MODE_ERR so the error queue gets read.
+ *
+ * @param node Scheduler node which received EPOLLERR.
+ */
+static void rinoo_epoll_errqueue(t_sched_node *node)
+{
+	int error;
+	socklen_t len;
+
+	len = sizeof(error);
+	if (unlikely(getsockopt(node->fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0)) {
+		error = errno;
+	}
+	if (error != 0) {
+		rinoo_sched_wakeup(node, RINOO_MODE_NONE, error);
+	} else {
+		rinoo_sched_wakeup(node, RINOO_MODE_ERR, 0);
+	}
+}
+
+/**
+ * Start polling.
+ *
+ * @param sched Pointer to the scheduler to use.
+ * @param timeout Maximum time to wait in nanoseconds (-1 for no timeout)
  *
  * @return 0 if succeeds, else -1.
  */
-int rinoo_epoll_poll(t_sched *sched, int timeout)
+int rinoo_epoll_poll(t_sched *sched, int64_t timeout)
 {
 	int nbevents;
 	struct epoll_event *event;
 
 	XASSERT(sched != NULL, -1);
 
-	nbevents = epoll_wait(sched->epoll.fd, sched->epoll.events, RINOO_EPOLL_MAX_EVENTS, timeout);
+	nbevents = rinoo_epoll_wait(sched, timeout);
 	if (unlikely(nbevents == -1)) {
 		/* We don't want to raise an error in this case */
 		return 0;
 	}
 	for (sched->epoll.curevent = 0; sched->epoll.curevent < nbevents; sched->epoll.curevent++) {
 		event = &sched->epoll.events[sched->epoll.curevent];
+		if (unlikely(event->data.ptr == &sched->epoll)) {
+			/* Stop request from the parent scheduler (see rinoo_spawn_stop) */
+			sched->stop = true;
+			continue;
+		}
 		/* Check event->data.ptr for every event as one event could call rinoo_epoll_remove and destroy ptr */
 		if (event->data.ptr != NULL && (event->events & EPOLLIN) == EPOLLIN) {
 			rinoo_sched_wakeup(event->data.ptr, RINOO_MODE_IN, 0);
@@ -145,7 +226,9 @@ int rinoo_epoll_poll(t_sched *sched, int timeout)
 		if (event->data.ptr != NULL && (event->events & EPOLLOUT) == EPOLLOUT) {
 			rinoo_sched_wakeup(event->data.ptr, RINOO_MODE_OUT, 0);
 		}
-		if (event->data.ptr != NULL && (((event->events & EPOLLERR) == EPOLLERR || (event->events & EPOLLHUP) == EPOLLHUP))) {
+		if (event->data.ptr != NULL && (event->events & (EPOLLERR | EPOLLHUP)) == EPOLLERR && ((t_sched_node *) event->data.ptr)->errqueue) {
+			rinoo_epoll_errqueue(event->data.ptr);
+		} else if (event->data.ptr != NULL && (((event->events & EPOLLERR) == EPOLLERR || (event->events & EPOLLHUP) == EPOLLHUP))) {
 			rinoo_sched_wakeup(event->data.ptr, RINOO_MODE_NONE, ECONNRESET);
 		}
 	}
@@ -0,0 +1,79 @@
+/**
+ * @file   pipe.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 19:33:05 2026
+ *
+ * @brief  Scheduler pipe pool
+ *
+ *
+ */
+
+#include "rinoo/scheduler/module.h"
+
+/**
+ * Gets a non-blocking pipe from the scheduler pool.
+ * A new pipe is created if the pool is empty.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param fds Array where to store the pipe read and write ends
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_pipe_get(t_sched *sched, int fds[2])
+{
+	XASSERT(sched != NULL, -1);
+
+	if (sched->pipes.count > 0) {
+		sched->pipes.count--;
+		fds[0] = sched->pipes.fds[sched->pipes.count][0];
+		fds[1] = sched->pipes.fds[sched->pipes.count][1];
+		return 0;
+	}
+	if (pipe(fds) != 0) {
+		return -1;
+	}
+	if (fcntl(fds[0], F_SETFL, O_NONBLOCK) != 0 || fcntl(fds[1], F_SETFL, O_NONBLOCK) != 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * Gives a pipe back to the scheduler pool.
+ * The pipe is closed if it may still hold data or if the pool is full.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param fds Pipe read and write ends
+ * @param empty Whether the pipe has been fully drained
+ */
+void rinoo_pipe_release(t_sched *sched, int fds[2], bool empty)
+{
+	XASSERTN(sched != NULL);
+
+	if (!empty || sched->pipes.count >= RINOO_SCHED_PIPES_MAX) {
+		close(fds[0]);
+		close(fds[1]);
+		return;
+	}
+	sched->pipes.fds[sched->pipes.count][0] = fds[0];
+	sched->pipes.fds[sched->pipes.count][1] = fds[1];
+	sched->pipes.count++;
+}
+
+/**
+ * Closes every pipe of the scheduler pool.
+ *
+ * @param sched Pointer to the scheduler to use
+ */
+void rinoo_pipe_destroy(t_sched *sched)
+{
+	XASSERTN(sched != NULL);
+
+	while (sched->pipes.count > 0) {
+		sched->pipes.count--;
+		close(sched->pipes.fds[sched->pipes.count][0]);
+		close(sched->pipes.fds[sched->pipes.count][1]);
+	}
+}
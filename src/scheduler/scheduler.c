@@ -10,6 +10,19 @@
 
 #include "rinoo/scheduler/module.h"
 
+/**
+ * Updates scheduler clock.
+ *
+ * @param sched Pointer to the scheduler to update
+ */
+static void rinoo_sched_clock(t_sched *sched)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	sched->clock = ts.tv_sec * RINOO_NSEC_PER_SEC + ts.tv_nsec;
+}
+
 /**
  * Create a new scheduler.
  *
@@ -28,6 +41,7 @@ t_sched *rinoo_sched(void)
 		free(sched);
 		return NULL;
 	}
+	rinoo_signal_init(sched);
 	if (rinoo_epoll_init(sched) != 0) {
 		rinoo_sched_destroy(sched);
 		return NULL;
@@ -36,7 +50,8 @@ t_sched *rinoo_sched(void)
 		rinoo_sched_destroy(sched);
 		return NULL;
 	}
-	gettimeofday(&sched->clock, NULL);
+	rinoo_slab_owner(sched, pthread_self());
+	rinoo_sched_clock(sched);
 	return sched;
 }
 
@@ -67,7 +82,10 @@ void rinoo_sched_destroy(t_sched *sched)
 	rinoo_task_driver_stop(sched);
 	list_flush(&sched->nodes, rinoo_sched_cancel_task);
 	rinoo_task_driver_destroy(sched);
+	rinoo_signal_destroy(sched);
+	rinoo_pipe_destroy(sched);
 	rinoo_epoll_destroy(sched);
+	rinoo_slab_destroy(sched);
 	free(sched);
 }
 
@@ -102,6 +120,8 @@ int rinoo_sched_waitfor(t_sched_node *node, t_sched_mode mode)
 
 	XASSERT(mode != RINOO_MODE_NONE, -1);
 
+	/* Pending writes must go out before this task may park */
+	rinoo_task_flush(rinoo_task_driver_getcurrent(node->sched));
 	if (node->error != 0) {
 		error = node->error;
 		rinoo_sched_remove(node);
@@ -142,6 +162,14 @@ int rinoo_sched_waitfor(t_sched_node *node, t_sched_mode mode)
 		node->sched->nbpending--;
 		return 0;
 	}
+	if (rinoo_task_deadline_check(node->task) != 0) {
+		error = errno;
+		node->sched->nbpending--;
+		node->task = NULL;
+		rinoo_sched_remove(node);
+		errno = error;
+		return -1;
+	}
 	if (rinoo_task_release(node->sched) != 0 && node->error == 0) {
 		node->error = errno;
 	}
@@ -180,6 +208,8 @@ int rinoo_sched_remove(t_sched_node *node)
 	if (rinoo_epoll_remove(node) != 0) {
 		return -1;
 	}
+	/* Next wait has to register the node again */
+	node->waiting = RINOO_MODE_NONE;
 	node->task = NULL;
 	return 0;
 }
@@ -243,9 +273,9 @@ static bool rinoo_sched_end(t_sched *sched)
  */
 int rinoo_sched_poll(t_sched *sched)
 {
-	int timeout;
+	int64_t timeout;
 
-	gettimeofday(&sched->clock, NULL);
+	rinoo_sched_clock(sched);
 	timeout = rinoo_task_driver_run(sched);
 	if (!rinoo_sched_end(sched)) {
 		return rinoo_epoll_poll(sched, timeout);
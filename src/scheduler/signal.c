@@ -0,0 +1,103 @@
+/**
+ * @file   signal.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 12:50:11 2026
+ *
+ * @brief  Signal delivery to tasks through signalfd
+ *
+ *
+ */
+
+#include "rinoo/scheduler/module.h"
+
+/**
+ * Initializes scheduler signal handling.
+ * The signalfd is only created on first rinoo_signal_wait call.
+ *
+ * @param sched Pointer to the scheduler to use
+ */
+void rinoo_signal_init(t_sched *sched)
+{
+	XASSERTN(sched != NULL);
+
+	memset(&sched->signal, 0, sizeof(sched->signal));
+	sched->signal.node.fd = -1;
+	sched->signal.node.sched = sched;
+}
+
+/**
+ * Destroys scheduler signal handling. Closes the signalfd if any.
+ *
+ * @param sched Pointer to the scheduler to use
+ */
+void rinoo_signal_destroy(t_sched *sched)
+{
+	XASSERTN(sched != NULL);
+
+	if (sched->signal.node.fd != -1) {
+		rinoo_sched_remove(&sched->signal.node);
+		close(sched->signal.node.fd);
+		sched->signal.node.fd = -1;
+	}
+}
+
+/**
+ * Waits for one of the signals in mask to be delivered.
+ * Signals in mask get blocked in the calling thread so they are only
+ * received through the scheduler. Spawns leave process signals to the
+ * main thread, so this is expected to be called from the main scheduler.
+ * Only one task per scheduler can wait for signals at a time.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param mask Set of signals to wait for
+ *
+ * @return Signal number on success, or -1 if an error occurs
+ */
+int rinoo_signal_wait(t_sched *sched, const sigset_t *mask)
+{
+	int fd;
+	ssize_t ret;
+
+	XASSERT(sched != NULL, -1);
+	XASSERT(mask != NULL, -1);
+
+	if (sched->signal.node.task != NULL) {
+		errno = EBUSY;
+		return -1;
+	}
+	if (pthread_sigmask(SIG_BLOCK, mask, NULL) != 0) {
+		return -1;
+	}
+	/* Signals outside of mask stay pending until they are waited for */
+	fd = signalfd(sched->signal.node.fd, mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	if (fd < 0) {
+		return -1;
+	}
+	sched->signal.node.fd = fd;
+	errno = 0;
+	while ((ret = read(fd, &sched->signal.info, sizeof(sched->signal.info))) < 0) {
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			return -1;
+		}
+		if (rinoo_sched_waitfor(&sched->signal.node, RINOO_MODE_IN) != 0) {
+			return -1;
+		}
+		errno = 0;
+	}
+	if (ret != sizeof(sched->signal.info)) {
+		return -1;
+	}
+	return sched->signal.info.ssi_signo;
+}
+
+/**
+ * Gets information about the last signal received by rinoo_signal_wait.
+ *
+ * @param sched Pointer to the scheduler to use
+ *
+ * @return Pointer to the signal information
+ */
+struct signalfd_siginfo *rinoo_signal_info(t_sched *sched)
+{
+	return &sched->signal.info;
+}
@@ -0,0 +1,220 @@
+/**
+ * @file   slab.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 22:07:41 2026
+ *
+ * @brief  Scheduler object slabs
+ *
+ *
+ */
+
+#include "rinoo/scheduler/module.h"
+
+/* Objects are 16 bytes aligned, like malloc ones */
+#define RINOO_SLAB_STRIDE(size)	(sizeof(t_slab_object) + (((size) + 15) & ~((size_t) 15)))
+
+/**
+ * Gets the slab serving a given object size.
+ * Slabs are bound to a size on first use.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param size Object size
+ *
+ * @return Pointer to the slab or NULL if every slab serves another size
+ */
+static t_slab *rinoo_slab_get(t_sched *sched, size_t size)
+{
+	int i;
+	t_slab *slab;
+
+	for (i = 0; i < RINOO_SCHED_SLABS; i++) {
+		slab = &sched->slabs.slabs[i];
+		if (slab->stats.size == size) {
+			return slab;
+		}
+		if (slab->stats.size == 0) {
+			slab->stats.size = size;
+			slab->parent = &sched->slabs;
+			return slab;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Adds a chunk of free objects to a slab.
+ *
+ * @param slab Pointer to the slab to grow
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+static int rinoo_slab_grow(t_slab *slab)
+{
+	int i;
+	char *chunk;
+	size_t stride;
+	t_slab_object *object;
+
+	stride = RINOO_SLAB_STRIDE(slab->stats.size);
+	/* First object slot links chunks together */
+	chunk = malloc(stride * (RINOO_SLAB_CHUNK + 1));
+	if (unlikely(chunk == NULL)) {
+		return -1;
+	}
+	*(void **) chunk = slab->chunks;
+	slab->chunks = chunk;
+	for (i = 1; i <= RINOO_SLAB_CHUNK; i++) {
+		object = (t_slab_object *)(chunk + i * stride);
+		object->slab = slab;
+		object->next = slab->free;
+		slab->free = object;
+	}
+	slab->stats.capacity += RINOO_SLAB_CHUNK;
+	return 0;
+}
+
+/**
+ * Sets the thread owning the slabs of a scheduler.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param owner Thread running the scheduler, 0 while it is not started
+ */
+void rinoo_slab_owner(t_sched *sched, pthread_t owner)
+{
+	XASSERTN(sched != NULL);
+
+	__atomic_store_n(&sched->slabs.owner, owner, __ATOMIC_RELEASE);
+}
+
+/**
+ * Tells whether the calling thread owns the slabs of a scheduler.
+ *
+ * @param slabs Pointer to the scheduler slabs
+ *
+ * @return true if the slabs can be used from this thread
+ */
+static bool rinoo_slab_owned(t_sched_slabs *slabs)
+{
+	pthread_t owner;
+
+	owner = __atomic_load_n(&slabs->owner, __ATOMIC_ACQUIRE);
+	return (owner != 0 && pthread_equal(owner, pthread_self()));
+}
+
+/**
+ * Allocates a zeroed object from a scheduler slab.
+ * Slabs are not locked: only the thread running the scheduler uses
+ * them, other threads (for instance rinoo_socket_dup to a running
+ * spawn) get objects from malloc, as they do when the slab is full.
+ * Slab objects must be freed from the scheduler thread.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param size Object size
+ *
+ * @return Pointer to the object or NULL if an error occurs
+ */
+void *rinoo_slab_alloc(t_sched *sched, size_t size)
+{
+	t_slab *slab;
+	t_slab_object *object;
+
+	XASSERT(sched != NULL, NULL);
+	XASSERT(size > 0, NULL);
+
+	if (!rinoo_slab_owned(&sched->slabs)) {
+		slab = NULL;
+	} else {
+		slab = rinoo_slab_get(sched, size);
+	}
+	if (slab != NULL && slab->free == NULL && slab->stats.capacity < RINOO_SLAB_MAX) {
+		rinoo_slab_grow(slab);
+	}
+	if (slab == NULL || slab->free == NULL) {
+		object = malloc(sizeof(*object) + size);
+		if (unlikely(object == NULL)) {
+			return NULL;
+		}
+		object->slab = NULL;
+		if (slab != NULL) {
+			slab->stats.fallbacks++;
+		}
+	} else {
+		object = slab->free;
+		slab->free = object->next;
+		slab->stats.used++;
+		slab->stats.allocs++;
+	}
+	object->next = NULL;
+	memset(object + 1, 0, size);
+	return object + 1;
+}
+
+/**
+ * Gives an object back to its slab.
+ *
+ * @param ptr Pointer to the object, as returned by rinoo_slab_alloc
+ */
+void rinoo_slab_free(void *ptr)
+{
+	t_slab_object *object;
+
+	if (ptr == NULL) {
+		return;
+	}
+	object = (t_slab_object *) ptr - 1;
+	if (object->slab == NULL) {
+		free(object);
+		return;
+	}
+	XASSERTN(rinoo_slab_owned(object->slab->parent));
+	object->next = object->slab->free;
+	object->slab->free = object;
+	object->slab->stats.used--;
+}
+
+/**
+ * Gets occupancy statistics of the slab serving a given object size.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param size Object size
+ * @param stats Pointer where to store statistics
+ *
+ * @return 0 on success or -1 if no slab serves this size
+ */
+int rinoo_slab_stats(t_sched *sched, size_t size, t_slab_stats *stats)
+{
+	int i;
+
+	XASSERT(sched != NULL, -1);
+	XASSERT(stats != NULL, -1);
+
+	for (i = 0; i < RINOO_SCHED_SLABS; i++) {
+		if (sched->slabs.slabs[i].stats.size == size) {
+			*stats = sched->slabs.slabs[i].stats;
+			return 0;
+		}
+	}
+	errno = ENOENT;
+	return -1;
+}
+
+/**
+ * Frees every slab of a scheduler.
+ * Objects still in use become invalid.
+ *
+ * @param sched Pointer to the scheduler to use
+ */
+void rinoo_slab_destroy(t_sched *sched)
+{
+	int i;
+	void *next;
+	void *chunk;
+
+	for (i = 0; i < RINOO_SCHED_SLABS; i++) {
+		for (chunk = sched->slabs.slabs[i].chunks; chunk != NULL; chunk = next) {
+			next = *(void **) chunk;
+			free(chunk);
+		}
+	}
+	memset(&sched->slabs, 0, sizeof(sched->slabs));
+}
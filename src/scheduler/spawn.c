@@ -10,6 +10,33 @@
 
 #include "rinoo/scheduler/module.h"
 
+/**
+ * Creates the eventfd used to stop a spawn and registers it in the
+ * spawn poller. The parent scheduler owns it, so it can still be written
+ * once the spawn destroyed itself.
+ *
+ * @param child Spawn scheduler
+ * @param thread Spawn thread
+ *
+ * @return 0 on success otherwise -1
+ */
+static int rinoo_spawn_stopfd(t_sched *child, t_thread *thread)
+{
+	struct epoll_event ev = { 0, { 0 } };
+
+	thread->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (thread->fd < 0) {
+		return -1;
+	}
+	ev.events = EPOLLIN | EPOLLET;
+	ev.data.ptr = &child->epoll;
+	if (epoll_ctl(child->epoll.fd, EPOLL_CTL_ADD, thread->fd, &ev) != 0) {
+		close(thread->fd);
+		return -1;
+	}
+	return 0;
+}
+
 /**
  * Spawns a number of children schedulers.
  *
@@ -43,6 +70,12 @@ int rinoo_spawn(t_sched *sched, int count)
 			return -1;
 		}
 		child->id = i + 1;
+		child->driver.stack_stats.enabled = sched->driver.stack_stats.enabled;
+		if (rinoo_spawn_stopfd(child, &sched->spawns.thread[i]) != 0) {
+			rinoo_sched_destroy(child);
+			sched->spawns.count = i;
+			return -1;
+		}
 		sched->spawns.thread[i].id = 0;
 		sched->spawns.thread[i].sched = child;
 	}
@@ -57,7 +90,12 @@ int rinoo_spawn(t_sched *sched, int count)
  */
 void rinoo_spawn_destroy(t_sched *sched)
 {
+	int i;
+
 	if (sched->spawns.thread != NULL) {
+		for (i = 0; i < sched->spawns.count; i++) {
+			close(sched->spawns.thread[i].fd);
+		}
 		free(sched->spawns.thread);
 	}
 	sched->spawns.count = 0;
@@ -92,26 +130,12 @@ t_sched *rinoo_spawn_get(t_sched *sched, int id)
  */
 static void *rinoo_spawn_loop(void *sched)
 {
+	rinoo_slab_owner(sched, pthread_self());
 	rinoo_sched_loop(sched);
 	rinoo_sched_destroy(sched);
 	return NULL;
 }
 
-/**
- * Signal handler called when killing threads.
- * This will stop the running scheduler.
- *
- * @param unused Signal number
- */
-static void rinoo_spawn_handler_stop(int unused(sig))
-{
-	t_sched *sched = rinoo_sched_self();
-
-	if (sched != NULL) {
-		rinoo_sched_stop(sched);
-	}
-}
-
 /**
  * Starts spawns. It creates a thread for each spawn.
  *
@@ -125,15 +149,18 @@ int rinoo_spawn_start(t_sched *sched)
 	sigset_t oldset;
 	sigset_t newset;
 
-	sigemptyset(&newset);
-	if (sigaddset(&newset, SIGINT) < 0) {
-		return -1;
-	}
-	if (sigaction(SIGUSR2, &(struct sigaction){ .sa_handler = rinoo_spawn_handler_stop }, NULL) != 0) {
-		return -1;
-	}
+	/*
+	 * Spawns inherit a mask blocking every signal, they are stopped
+	 * through their eventfd. Process signals are then always delivered
+	 * to the main thread, where they can be handled by rinoo_signal_wait.
+	 */
+	sigfillset(&newset);
 	pthread_sigmask(SIG_BLOCK, &newset, &oldset);
 	for (i = 0; i < sched->spawns.count; i++) {
+		/* Spawns inherit settings before their thread starts */
+		sched->spawns.thread[i].sched->driver.stack_stats.enabled = sched->driver.stack_stats.enabled;
+		/* Slabs belong to the spawn thread once it runs */
+		rinoo_slab_owner(sched->spawns.thread[i].sched, 0);
 		if (pthread_create(&sched->spawns.thread[i].id, NULL, rinoo_spawn_loop, sched->spawns.thread[i].sched) != 0) {
 			pthread_sigmask(SIG_SETMASK, &oldset, NULL);
 			return -1;
@@ -155,7 +182,9 @@ void rinoo_spawn_stop(t_sched *sched)
 	for (i = 0; i < sched->spawns.count; i++) {
 		if (sched->spawns.thread[i].id != 0) {
 			sched->spawns.thread[i].sched = NULL;
-			pthread_kill(sched->spawns.thread[i].id, SIGUSR2);
+			if (eventfd_write(sched->spawns.thread[i].fd, 1) != 0) {
+				rinoo_log("spawn %d - could not be stopped: %s", i + 1, strerror(errno));
+			}
 		}
 	}
 }
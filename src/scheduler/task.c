@@ -24,7 +24,7 @@ static int rinoo_task_cmp(t_rbtree_node *node1, t_rbtree_node *node2)
 	if (task1 == task2) {
 		return 0;
 	}
-	if (timercmp(&task1->tv, &task2->tv, <)) {
+	if (task1->time < task2->time) {
 		return -1;
 	}
 	return 1;
@@ -64,29 +64,27 @@ void rinoo_task_driver_destroy(t_sched *sched)
 }
 
 /**
- * Runs pending tasks and returns time before next task (in ms).
+ * Runs pending tasks and returns time before next task (in ns).
  * If no task is queued, -1 is returned.
  *
  * @param sched Pointer to the scheduler to use
  *
- * @return Time before next task in ms or -1 if no task is queued
+ * @return Time before next task in ns or -1 if no task is queued
  */
-int rinoo_task_driver_run(t_sched *sched)
+int64_t rinoo_task_driver_run(t_sched *sched)
 {
 	t_task *task;
-	struct timeval tv;
 	t_rbtree_node *head;
 
 	XASSERT(sched != NULL, -1);
 
 	while ((head = rbtree_head(&sched->driver.proc_tree)) != NULL) {
 		task = container_of(head, t_task, proc_node);
-		if (timercmp(&task->tv, &sched->clock, <=)) {
+		if (task->time <= sched->clock) {
 			rinoo_task_unschedule(task);
 			rinoo_task_resume(task);
 		} else {
-			timersub(&task->tv, &sched->clock, &tv);
-			return (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+			return task->time - sched->clock;
 		}
 	}
 	return -1;
@@ -139,10 +137,26 @@ t_task *rinoo_task_driver_getcurrent(t_sched *sched)
 	return sched->driver.current;
 }
 
+/**
+ * Task entry point. Runs the task routine then flushes what the
+ * task left pending, while still running on the task stack.
+ *
+ * @param arg Pointer to the task
+ */
+static void rinoo_task_main(void *arg)
+{
+	t_task *task = arg;
+
+	task->function(task->arg);
+	rinoo_task_flush(task);
+}
+
 /**
  * Create a new task.
+ * The new task inherits the deadline of its parent.
  *
  * @param sched sched Pointer to a scheduler to use
+ * @param parent Pointer to the task to return to once the new task is over
  * @param function Routine to call for that task
  * @param arg Routine argument to be passed
  *
@@ -165,9 +179,17 @@ t_task *rinoo_task(t_sched *sched, t_task *parent, void (*function)(void *arg),
 	task->context.stack.sp = task->stack;
 	task->context.stack.size = sizeof(task->stack);
 	task->context.link = &parent->context;
-	memset(&task->tv, 0, sizeof(task->tv));
+	task->stack_check = sched->driver.stack_stats.enabled;
+	if (unlikely(task->stack_check)) {
+		memset(task->stack, RINOO_TASK_STACK_PAINT, sizeof(task->stack));
+	}
+	task->time = 0;
+	task->deadline = parent->deadline;
 	memset(&task->proc_node, 0, sizeof(task->proc_node));
-	fcontext(&task->context, function, arg);
+	list(&task->flushes, NULL);
+	task->function = function;
+	task->arg = arg;
+	fcontext(&task->context, rinoo_task_main, task);
 
 #ifdef RINOO_DEBUG
 	/* This code avoids valgrind to mix stack switches */
@@ -177,6 +199,33 @@ t_task *rinoo_task(t_sched *sched, t_task *parent, void (*function)(void *arg),
 	return task;
 }
 
+/**
+ * Measures task stack usage from the paint applied at task creation.
+ * Aborts if the stack guard has been overwritten.
+ *
+ * @param task Pointer to the task to check
+ */
+static void rinoo_task_stack_measure(t_task *task)
+{
+	size_t i;
+	size_t used;
+	t_task_stack_stats *stats;
+
+	for (i = 0; i < sizeof(task->stack) && (unsigned char) task->stack[i] == RINOO_TASK_STACK_PAINT; i++);
+	used = sizeof(task->stack) - i;
+	if (unlikely(i < RINOO_TASK_STACK_GUARD)) {
+		rinoo_log("Task stack overflow: task %p on scheduler %d used at least %zu/%zu bytes, guard damaged at offset %zu",
+			  task, task->sched->id, used, sizeof(task->stack), i);
+		abort();
+	}
+	stats = &task->sched->driver.stack_stats;
+	stats->nbtasks++;
+	stats->histogram[used / RINOO_TASK_STACK_BUCKET]++;
+	if (used > stats->max) {
+		stats->max = used;
+	}
+}
+
 /**
  * Destroy a task.
  *
@@ -186,10 +235,23 @@ void rinoo_task_destroy(t_task *task)
 {
 	XASSERTN(task != NULL);
 
+	if (unlikely(task->stack_check)) {
+		rinoo_task_stack_measure(task);
+	}
+
 #ifdef RINOO_DEBUG
 	VALGRIND_STACK_DEREGISTER(task->valgrind_stackid);
 #endif /* !RINOO_DEBUG */
 	rinoo_task_unschedule(task);
+	while (list_head(&task->flushes) != NULL) {
+		/*
+		 * No write can block from here. Pending data stays with its
+		 * owner (a coalescing socket sends it with its next write,
+		 * flush or close).
+		 */
+		rinoo_log("Task %p destroyed with pending data to flush", (void *) task);
+		rinoo_task_flush_remove(container_of(list_head(&task->flushes), t_task_flush, lnode));
+	}
 	free(task);
 }
 
@@ -267,6 +329,9 @@ int rinoo_task_resume(t_task *task)
 
 /**
  * Release execution of a task currently running on a scheduler.
+ * Pending writes of the task are flushed first. The wake up time of
+ * the task is put aside meanwhile, so that a flush which has to wait
+ * is not interrupted by it.
  *
  * @param sched Pointer to the scheduler to use
  *
@@ -274,8 +339,26 @@ int rinoo_task_resume(t_task *task)
  */
 int rinoo_task_release(t_sched *sched)
 {
+	bool scheduled;
+	uint64_t time;
+	t_task *task;
+
 	XASSERT(sched != NULL, -1);
 
+	task = sched->driver.current;
+	if (task != &sched->driver.main && unlikely(list_head(&task->flushes) != NULL)) {
+		scheduled = task->scheduled;
+		time = task->time;
+		rinoo_task_unschedule(task);
+		rinoo_task_flush(task);
+		if (scheduled) {
+			if (rinoo_task_schedule_ns(task, time) != 0) {
+				return -1;
+			}
+		} else {
+			rinoo_task_unschedule(task);
+		}
+	}
 	fcontext_swap(&sched->driver.current->context, &sched->driver.main.context);
 	if (sched->stop == true) {
 		errno = ECANCELED;
@@ -293,6 +376,22 @@ int rinoo_task_release(t_sched *sched)
  * @return 0 on success or -1 if an error occurs
  */
 int rinoo_task_schedule(t_task *task, struct timeval *tv)
+{
+	if (tv == NULL) {
+		return rinoo_task_schedule_ns(task, 0);
+	}
+	return rinoo_task_schedule_ns(task, tv->tv_sec * RINOO_NSEC_PER_SEC + tv->tv_usec * RINOO_NSEC_PER_USEC);
+}
+
+/**
+ * Schedule a task to be executed at specific time.
+ *
+ * @param task Pointer to the task to schedule
+ * @param time Expected execution time in ns since Epoch (0 for as soon as possible)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_schedule_ns(t_task *task, uint64_t time)
 {
 	XASSERT(task != NULL, -1);
 	XASSERT(task->sched != NULL, -1);
@@ -301,11 +400,7 @@ int rinoo_task_schedule(t_task *task, struct timeval *tv)
 		rbtree_remove(&task->sched->driver.proc_tree, &task->proc_node);
 		task->scheduled = false;
 	}
-	if (tv != NULL) {
-		task->tv = *tv;
-	} else {
-		memset(&task->tv, 0, sizeof(task->tv));
-	}
+	task->time = time;
 	if (rbtree_put(&task->sched->driver.proc_tree, &task->proc_node) != 0) {
 		return -1;
 	}
@@ -327,7 +422,7 @@ int rinoo_task_unschedule(t_task *task)
 
 	if (task->scheduled == true) {
 		rbtree_remove(&task->sched->driver.proc_tree, &task->proc_node);
-		memset(&task->tv, 0, sizeof(task->tv));
+		task->time = 0;
 		task->scheduled = false;
 	}
 	return 0;
@@ -343,20 +438,54 @@ int rinoo_task_unschedule(t_task *task)
  */
 int rinoo_task_wait(t_sched *sched, uint32_t ms)
 {
-	struct timeval res;
-	struct timeval toadd;
+	return rinoo_task_wait_ns(sched, ms * RINOO_NSEC_PER_MSEC);
+}
 
-	if (ms == 0) {
-		if (rinoo_task_schedule(rinoo_task_driver_getcurrent(sched), NULL) != 0) {
+/**
+ * Release a task for a given time.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param ns Release time in nanoseconds
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_wait_ns(t_sched *sched, uint64_t ns)
+{
+	if (ns == 0) {
+		return rinoo_task_wait_until(sched, 0);
+	}
+	return rinoo_task_wait_until(sched, sched->clock + ns);
+}
+
+/**
+ * Release a task until a given time.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param time Time to wake up at, in ns since Epoch (0 for as soon as possible)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_wait_until(t_sched *sched, uint64_t time)
+{
+	t_task *task;
+
+	task = rinoo_task_driver_getcurrent(sched);
+	if (task->deadline != 0 && task->deadline < time) {
+		/* Wake up at deadline and report it */
+		if (rinoo_task_deadline_check(task) != 0) {
 			return -1;
 		}
-	} else {
-		toadd.tv_sec = ms / 1000;
-		toadd.tv_usec = (ms % 1000) * 1000;
-		timeradd(&sched->clock, &toadd, &res);
-		if (rinoo_task_schedule(rinoo_task_driver_getcurrent(sched), &res) != 0) {
+		if (rinoo_task_schedule_ns(task, task->deadline) != 0) {
 			return -1;
 		}
+		if (rinoo_task_release(sched) != 0) {
+			return -1;
+		}
+		errno = ETIMEDOUT;
+		return -1;
+	}
+	if (rinoo_task_schedule_ns(task, time) != 0) {
+		return -1;
 	}
 	return rinoo_task_release(sched);
 }
@@ -372,21 +501,21 @@ int rinoo_task_wait(t_sched *sched, uint32_t ms)
 int rinoo_task_pause(t_sched *sched)
 {
 	t_task *task;
-	struct timeval tv;
+	uint64_t time;
 
 	task = rinoo_task_driver_getcurrent(sched);
 	if (task == &sched->driver.main) {
 		return 0;
 	}
 	if (task->scheduled == true) {
-		tv = task->tv;
+		time = task->time;
 		if (rinoo_task_schedule(task, NULL) != 0) {
 			return -1;
 		}
 		if (rinoo_task_release(sched) != 0) {
 			return -1;
 		}
-		if (rinoo_task_schedule(task, &tv) != 0) {
+		if (rinoo_task_schedule_ns(task, time) != 0) {
 			return -1;
 		}
 	} else {
@@ -400,6 +529,88 @@ int rinoo_task_pause(t_sched *sched)
 	return 0;
 }
 
+/**
+ * Sets a deadline to the current task.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param ms Time budget from now in milliseconds (0 to remove the deadline)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_deadline(t_sched *sched, uint32_t ms)
+{
+	return rinoo_task_deadline_ns(sched, ms * RINOO_NSEC_PER_MSEC);
+}
+
+/**
+ * Sets a deadline to the current task.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param ns Time budget from now in nanoseconds (0 to remove the deadline)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_deadline_ns(t_sched *sched, uint64_t ns)
+{
+	if (ns == 0) {
+		return rinoo_task_deadline_until(sched, 0);
+	}
+	return rinoo_task_deadline_until(sched, sched->clock + ns);
+}
+
+/**
+ * Sets a deadline to the current task.
+ * Every blocking operation of the task (socket IO, channels, waits) fails
+ * with ETIMEDOUT once the deadline is reached. A single timer is armed for
+ * the whole deadline. Tasks created by the current task inherit its deadline.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param time Deadline in ns since Epoch (0 to remove the deadline)
+ *
+ * @return 0 on success or -1 if an error occurs
+ */
+int rinoo_task_deadline_until(t_sched *sched, uint64_t time)
+{
+	t_task *task;
+
+	XASSERT(sched != NULL, -1);
+
+	task = rinoo_task_driver_getcurrent(sched);
+	if (task == &sched->driver.main) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (task->scheduled == true && task->deadline != 0 && task->time == task->deadline) {
+		/* Disarm previous deadline */
+		rinoo_task_unschedule(task);
+	}
+	task->deadline = time;
+	return 0;
+}
+
+/**
+ * Checks a task deadline before blocking.
+ * It arms the deadline timer if the task is not already scheduled earlier.
+ *
+ * @param task Pointer to the task about to block
+ *
+ * @return 0 if the task can block, or -1 with errno set to ETIMEDOUT if the deadline is reached
+ */
+int rinoo_task_deadline_check(t_task *task)
+{
+	if (likely(task->deadline == 0)) {
+		return 0;
+	}
+	if (task->deadline <= task->sched->clock) {
+		errno = ETIMEDOUT;
+		return -1;
+	}
+	if (task->scheduled == false || task->time > task->deadline) {
+		return rinoo_task_schedule_ns(task, task->deadline);
+	}
+	return 0;
+}
+
 /**
  * Gets current running task.
  *
@@ -410,3 +621,118 @@ t_task *rinoo_task_self(void)
 {
 	return current_task;
 }
+
+/**
+ * Registers a flush to be run before a task releases execution.
+ * Flushes run when the task waits for I/O, time or channels, and
+ * when the task ends. Registering a pending flush does nothing.
+ *
+ * @param task Pointer to the task which owes the flush
+ * @param flush Pointer to the flush to register
+ */
+void rinoo_task_flush_add(t_task *task, t_task_flush *flush)
+{
+	XASSERTN(task != NULL);
+	XASSERTN(flush != NULL);
+
+	if (flush->task != NULL) {
+		return;
+	}
+	flush->task = task;
+	list_put(&task->flushes, &flush->lnode);
+}
+
+/**
+ * Unregisters a pending flush.
+ *
+ * @param flush Pointer to the flush to unregister
+ */
+void rinoo_task_flush_remove(t_task_flush *flush)
+{
+	XASSERTN(flush != NULL);
+
+	if (flush->task == NULL) {
+		return;
+	}
+	list_remove(&flush->task->flushes, &flush->lnode);
+	flush->task = NULL;
+}
+
+/**
+ * Runs every pending flush of a task.
+ * Flushes are unregistered before running, so a flush which blocks
+ * and releases the task does not get called again.
+ *
+ * @param task Pointer to the task
+ */
+void rinoo_task_flush(t_task *task)
+{
+	t_task_flush *flush;
+
+	while (unlikely(list_head(&task->flushes) != NULL)) {
+		flush = container_of(list_head(&task->flushes), t_task_flush, lnode);
+		rinoo_task_flush_remove(flush);
+		flush->flush(flush);
+	}
+}
+
+/**
+ * Enables or disables task stack checking on a scheduler and its spawns.
+ * When enabled, task stacks are painted at creation and their high-water
+ * mark is measured on destruction. The process aborts if a task got close
+ * enough to the end of its stack to damage the guard area.
+ * Only tasks created while checking is enabled are measured.
+ * Spawns get the setting of their parent when they start: this must be
+ * called before rinoo_sched_loop, running spawns are left untouched.
+ *
+ * @param sched Pointer to the scheduler to use
+ * @param enabled Whether to enable stack checking
+ */
+void rinoo_task_stack_check(t_sched *sched, bool enabled)
+{
+	int i;
+
+	XASSERTN(sched != NULL);
+
+	sched->driver.stack_stats.enabled = enabled;
+	for (i = 0; i < sched->spawns.count; i++) {
+		/* Spawns not started yet are only used by this thread */
+		if (sched->spawns.thread[i].id == 0 && sched->spawns.thread[i].sched != NULL) {
+			sched->spawns.thread[i].sched->driver.stack_stats.enabled = enabled;
+		}
+	}
+}
+
+/**
+ * Gets task stack usage statistics of a scheduler.
+ * The histogram counts destroyed tasks by high-water mark, per RINOO_TASK_STACK_BUCKET bytes.
+ *
+ * @param sched Pointer to the scheduler to use
+ *
+ * @return Pointer to the scheduler stack statistics
+ */
+t_task_stack_stats *rinoo_task_stack_stats(t_sched *sched)
+{
+	return &sched->driver.stack_stats;
+}
+
+/**
+ * Logs task stack usage statistics of a scheduler.
+ *
+ * @param sched Pointer to the scheduler to use
+ */
+void rinoo_task_stack_report(t_sched *sched)
+{
+	int i;
+	t_task_stack_stats *stats;
+
+	stats = &sched->driver.stack_stats;
+	rinoo_log("Scheduler %d: %llu tasks, max stack usage %zu/%d bytes",
+		  sched->id, (unsigned long long) stats->nbtasks, stats->max, RINOO_TASK_STACK_SIZE);
+	for (i = 0; i < RINOO_TASK_STACK_NBBUCKETS; i++) {
+		if (stats->histogram[i] > 0) {
+			rinoo_log("  %5d - %5d bytes: %llu", i * RINOO_TASK_STACK_BUCKET, (i + 1) * RINOO_TASK_STACK_BUCKET - 1,
+				  (unsigned long long) stats->histogram[i]);
+		}
+	}
+}
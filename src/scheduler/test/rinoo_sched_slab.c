@@ -0,0 +1,123 @@
+/**
+ * @file   rinoo_sched_slab.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 22:24:12 2026
+ *
+ * @brief  Scheduler slab unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define NBOBJECTS	(RINOO_SLAB_CHUNK * 2)
+
+extern const t_socket_class socket_class_tcp;
+
+void *thread_func(void *sched)
+{
+	char *object;
+
+	/* Other threads do not use the scheduler slabs */
+	object = rinoo_slab_alloc(sched, 100);
+	if (object != NULL && object[0] == 0 && object[99] == 0) {
+		rinoo_slab_free(object);
+		return sched;
+	}
+	return NULL;
+}
+
+/**
+ * Main function for this unit test.
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	int i;
+	char *first;
+	char **many;
+	char *objects[NBOBJECTS];
+	pthread_t thread;
+	void *result;
+	void *other[RINOO_SCHED_SLABS];
+	t_sched *sched;
+	t_socket *socket;
+	t_slab_stats stats;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	for (i = 0; i < NBOBJECTS; i++) {
+		objects[i] = rinoo_slab_alloc(sched, 100);
+		XTEST(objects[i] != NULL);
+		XTEST(((uintptr_t) objects[i] & 15) == 0);
+		XTEST(objects[i][0] == 0 && objects[i][99] == 0);
+		memset(objects[i], 'a', 100);
+	}
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.capacity == NBOBJECTS);
+	XTEST(stats.used == NBOBJECTS);
+	first = objects[0];
+	for (i = 0; i < NBOBJECTS; i++) {
+		rinoo_slab_free(objects[i]);
+	}
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.used == 0);
+	/* Freed objects are reused, zeroed */
+	objects[0] = rinoo_slab_alloc(sched, 100);
+	XTEST(objects[0] == first || objects[0] == objects[NBOBJECTS - 1]);
+	XTEST(objects[0][0] == 0);
+	rinoo_slab_free(objects[0]);
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.capacity == NBOBJECTS);
+	XTEST(stats.allocs == NBOBJECTS + 1);
+
+	XTEST(pthread_create(&thread, NULL, thread_func, sched) == 0);
+	XTEST(pthread_join(thread, &result) == 0);
+	XTEST(result == sched);
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.used == 0);
+	XTEST(stats.allocs == NBOBJECTS + 1);
+	XTEST(stats.fallbacks == 0);
+
+	/* Full slabs fall back to malloc */
+	many = malloc(sizeof(*many) * (RINOO_SLAB_MAX + NBOBJECTS));
+	XTEST(many != NULL);
+	for (i = 0; i < RINOO_SLAB_MAX + NBOBJECTS; i++) {
+		many[i] = rinoo_slab_alloc(sched, 100);
+		XTEST(many[i] != NULL);
+	}
+	XTEST(many[RINOO_SLAB_MAX][0] == 0 && many[RINOO_SLAB_MAX][99] == 0);
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.capacity == RINOO_SLAB_MAX);
+	XTEST(stats.used == RINOO_SLAB_MAX);
+	XTEST(stats.fallbacks == NBOBJECTS);
+	for (i = 0; i < RINOO_SLAB_MAX + NBOBJECTS; i++) {
+		rinoo_slab_free(many[i]);
+	}
+	free(many);
+	XTEST(rinoo_slab_stats(sched, 100, &stats) == 0);
+	XTEST(stats.used == 0);
+	XTEST(stats.capacity == RINOO_SLAB_MAX);
+
+	/* Sockets come from the scheduler slab */
+	socket = rinoo_socket(sched, &socket_class_tcp);
+	XTEST(socket != NULL);
+	XTEST(rinoo_slab_stats(sched, sizeof(*socket), &stats) == 0);
+	XTEST(stats.used == 1);
+	rinoo_socket_destroy(socket);
+	XTEST(rinoo_slab_stats(sched, sizeof(*socket), &stats) == 0);
+	XTEST(stats.used == 0);
+
+	/* Sizes beyond the slab count use malloc */
+	for (i = 0; i < RINOO_SCHED_SLABS; i++) {
+		other[i] = rinoo_slab_alloc(sched, 200 + i);
+		XTEST(other[i] != NULL);
+	}
+	XTEST(rinoo_slab_stats(sched, 200 + RINOO_SCHED_SLABS - 1, &stats) == -1);
+	for (i = 0; i < RINOO_SCHED_SLABS; i++) {
+		rinoo_slab_free(other[i]);
+	}
+	rinoo_sched_destroy(sched);
+	XPASS();
+}
@@ -0,0 +1,58 @@
+/**
+ * @file   rinoo_signal_wait.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 13:12:40 2026
+ *
+ * @brief  rinoo_signal_wait unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+int checker = 0;
+
+void task_signal(void *sched)
+{
+	sigset_t mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGHUP);
+	sigaddset(&mask, SIGTERM);
+	rinoo_log("waiting for SIGHUP");
+	XTEST(rinoo_signal_wait(sched, &mask) == SIGHUP);
+	XTEST(rinoo_signal_info(sched)->ssi_pid == (uint32_t) getpid());
+	checker++;
+	rinoo_log("waiting for SIGTERM");
+	XTEST(rinoo_signal_wait(sched, &mask) == SIGTERM);
+	checker++;
+}
+
+void task_kill(void *sched)
+{
+	rinoo_task_wait(sched, 100);
+	XTEST(kill(getpid(), SIGHUP) == 0);
+	rinoo_task_wait(sched, 100);
+	XTEST(checker == 1);
+	XTEST(kill(getpid(), SIGTERM) == 0);
+}
+
+/**
+ * Main function for this unit test
+ *
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, task_signal, sched) == 0);
+	XTEST(rinoo_task_start(sched, task_kill, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 2);
+	XPASS();
+}
@@ -19,8 +19,8 @@ void task(void *unused(arg))
 	t_sched *cur;
 
 	rinoo_log("%s start %d", __FUNCTION__, rinoo_sched_self()->id);
-	/* sleep should return as soon as we get killed by the main scheduler */
-	sleep(1000);
+	/* Wait should return as soon as we get stopped by the main scheduler */
+	rinoo_task_wait(rinoo_sched_self(), 1000000);
 	cur = rinoo_sched_self();
 	XTEST(cur != NULL);
 	XTEST(cur->id >= 0 && cur->id <= NBSPAWNS);
@@ -0,0 +1,114 @@
+/**
+ * @file   rinoo_task_deadline.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 15:02:51 2026
+ *
+ * @brief  rinoo_task_deadline unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#ifdef RINOO_DEBUG
+#include <valgrind/valgrind.h>
+#define LATENCY			(10 + RUNNING_ON_VALGRIND * 110) * RINOO_NSEC_PER_MSEC
+#else
+#define LATENCY			10 * RINOO_NSEC_PER_MSEC
+#endif /* !RINOO_DEBUG */
+
+#define DEADLINE		200
+
+t_channel *channel;
+uint64_t start;
+int checker = 0;
+
+uint64_t now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec * RINOO_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+void child(void *unused(arg))
+{
+	int x;
+
+	XTEST(rinoo_task_self()->deadline != 0);
+	/* Nobody writes to the channel, the inherited deadline must stop us */
+	XTEST(rinoo_channel_read(channel, &x, sizeof(x)) == -1);
+	XTEST(errno == ETIMEDOUT);
+	XTEST(now() - start >= DEADLINE * RINOO_NSEC_PER_MSEC);
+	XTEST(now() - start < DEADLINE * RINOO_NSEC_PER_MSEC + LATENCY);
+	checker++;
+}
+
+void parent(void *sched)
+{
+	start = now();
+	XTEST(rinoo_task_deadline(sched, DEADLINE) == 0);
+	XTEST(rinoo_task_wait(sched, 10) == 0);
+	XTEST(rinoo_task_run(sched, child, NULL) == 0);
+	/* Deadline is over, every blocking operation fails right away */
+	XTEST(rinoo_task_wait(sched, 1000) == -1);
+	XTEST(errno == ETIMEDOUT);
+	XTEST(rinoo_channel_write(channel, &checker, sizeof(checker)) == -1);
+	XTEST(errno == ETIMEDOUT);
+	XTEST(now() - start < DEADLINE * RINOO_NSEC_PER_MSEC + LATENCY);
+	XTEST(rinoo_task_deadline(sched, 0) == 0);
+	XTEST(rinoo_task_wait(sched, 10) == 0);
+	checker++;
+}
+
+void server(void *sched)
+{
+	t_socket *server;
+	t_socket *client;
+
+	server = rinoo_tcp_server(sched, IP_ANY, 4242);
+	XTEST(server != NULL);
+	client = rinoo_tcp_accept(server, NULL, NULL);
+	XTEST(client != NULL);
+	rinoo_socket_destroy(server);
+	XTEST(rinoo_task_wait(sched, DEADLINE * 2) == 0);
+	rinoo_socket_destroy(client);
+}
+
+void client(void *sched)
+{
+	char a;
+	t_socket *socket;
+
+	XTEST(rinoo_task_deadline(sched, DEADLINE) == 0);
+	socket = rinoo_tcp_client(sched, IP_LOOPBACK, 4242, 0);
+	XTEST(socket != NULL);
+	XTEST(rinoo_socket_read(socket, &a, 1) == -1);
+	XTEST(errno == ETIMEDOUT);
+	rinoo_socket_destroy(socket);
+	checker++;
+}
+
+/**
+ * Main function for this unit test
+ *
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	channel = rinoo_channel(sched);
+	XTEST(channel != NULL);
+	XTEST(rinoo_task_start(sched, parent, sched) == 0);
+	XTEST(rinoo_task_start(sched, server, sched) == 0);
+	XTEST(rinoo_task_start(sched, client, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_channel_destroy(channel);
+	rinoo_sched_destroy(sched);
+	XTEST(checker == 3);
+	XPASS();
+}
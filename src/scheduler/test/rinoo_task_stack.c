@@ -0,0 +1,58 @@
+/**
+ * @file   rinoo_task_stack.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 14:05:37 2026
+ *
+ * @brief  Task stack usage instrumentation unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#define STACK_USAGE	(6 * 1024)
+
+void task_small(void *unused(arg))
+{
+	printf("%s\n", __FUNCTION__);
+}
+
+void task_big(void *unused(arg))
+{
+	size_t i;
+	volatile char buf[STACK_USAGE];
+
+	for (i = 0; i < sizeof(buf); i++) {
+		buf[i] = 0;
+	}
+	printf("%s\n", __FUNCTION__);
+}
+
+/**
+ * Main function for this unit test
+ *
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+	t_task_stack_stats *stats;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, task_small, NULL) == 0);
+	rinoo_task_stack_check(sched, true);
+	XTEST(rinoo_task_start(sched, task_small, NULL) == 0);
+	XTEST(rinoo_task_start(sched, task_big, NULL) == 0);
+	rinoo_sched_loop(sched);
+	stats = rinoo_task_stack_stats(sched);
+	rinoo_task_stack_report(sched);
+	XTEST(stats->nbtasks == 2);
+	XTEST(stats->max >= STACK_USAGE);
+	XTEST(stats->max < RINOO_TASK_STACK_SIZE - RINOO_TASK_STACK_GUARD);
+	XTEST(stats->histogram[0] == 1);
+	XTEST(stats->histogram[stats->max / RINOO_TASK_STACK_BUCKET] == 1);
+	rinoo_sched_destroy(sched);
+	XPASS();
+}
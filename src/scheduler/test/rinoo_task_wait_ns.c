@@ -0,0 +1,73 @@
+/**
+ * @file   rinoo_task_wait_ns.c
+ * @author Reginald Lips <reginald.l@gmail.com> - Copyright 2026
+ * @date   Sun Oct 18 13:40:02 2026
+ *
+ * @brief  rinoo_task_wait_ns/rinoo_task_wait_until unit test
+ *
+ *
+ */
+
+#include "rinoo/rinoo.h"
+
+#ifdef RINOO_DEBUG
+#include <valgrind/valgrind.h>
+#define LATENCY			(2 + RUNNING_ON_VALGRIND * 110) * RINOO_NSEC_PER_MSEC
+#else
+#define LATENCY			2 * RINOO_NSEC_PER_MSEC
+#endif /* !RINOO_DEBUG */
+
+uint64_t now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return ts.tv_sec * RINOO_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+int check_time(uint64_t *prev, uint64_t ns)
+{
+	uint64_t cur;
+	uint64_t diff;
+
+	cur = now();
+	diff = cur - *prev;
+	rinoo_log("Time diff found: %lluns, expected: %lluns", (unsigned long long) diff, (unsigned long long) ns);
+	if (diff < ns || diff > ns + LATENCY) {
+		return -1;
+	}
+	*prev = cur;
+	return 0;
+}
+
+void task_func(void *sched)
+{
+	uint64_t prev;
+
+	prev = now();
+	XTEST(rinoo_task_wait_ns(sched, 250 * RINOO_NSEC_PER_USEC) == 0);
+	XTEST(check_time(&prev, 250 * RINOO_NSEC_PER_USEC) == 0);
+	XTEST(rinoo_task_wait_ns(sched, 1500 * RINOO_NSEC_PER_USEC) == 0);
+	XTEST(check_time(&prev, 1500 * RINOO_NSEC_PER_USEC) == 0);
+	XTEST(rinoo_task_wait_until(sched, prev + 3 * RINOO_NSEC_PER_MSEC) == 0);
+	XTEST(check_time(&prev, 3 * RINOO_NSEC_PER_MSEC) == 0);
+	XTEST(rinoo_task_wait_ns(sched, 0) == 0);
+}
+
+/**
+ * Main function for this unit test
+ *
+ *
+ * @return 0 if test passed
+ */
+int main()
+{
+	t_sched *sched;
+
+	sched = rinoo_sched();
+	XTEST(sched != NULL);
+	XTEST(rinoo_task_start(sched, task_func, sched) == 0);
+	rinoo_sched_loop(sched);
+	rinoo_sched_destroy(sched);
+	XPASS();
+}